@@ -0,0 +1,206 @@
+//
+//  TonicBenchmark.cpp
+//  Tonic
+//
+//  Standalone microbenchmark for individual DSP nodes. Each node is ticked in isolation, one
+//  synthesis block at a time, exactly as it would be inside a Synth. Results are printed as JSON.
+//
+//  Usage: TonicBenchmark [secondsOfAudioPerNode] [nameFilter] [blockSize]
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#include "Tonic.h"
+#include <cstdlib>
+
+using namespace Tonic;
+
+namespace {
+
+  struct BenchmarkCase {
+    string      name;
+    Generator   node;
+    Generator   source;     // upstream signal ticked by node, timed separately and subtracted
+    bool        hasSource;
+  };
+
+  BenchmarkCase makeCase( string name, Generator node ){
+    BenchmarkCase bc;
+    bc.name = name;
+    bc.node = node;
+    bc.hasSource = false;
+    return bc;
+  }
+
+  BenchmarkCase makeCase( string name, Generator node, Generator source ){
+    BenchmarkCase bc = makeCase(name, node);
+    bc.source = source;
+    bc.hasSource = true;
+    return bc;
+  }
+
+  //! Wall-clock seconds to tick gen for nBlocks synthesis blocks. Best of nRuns to reject scheduler noise.
+  double timeGenerator( Generator gen, unsigned long nBlocks, unsigned int nRuns ){
+
+    TonicFrames frames(synthesisBlockSize(), gen.isStereoOutput() ? 2 : 1);
+    Tonic_::SynthesisContext_ context;
+    Tonic_::ScratchStack_ scratch(Tonic_::GraphSchedule_::scratchDepth(gen.rawGenerator()));
+    context.scratch = &scratch;
+
+    // warm up caches and let envelopes/delays reach steady state
+    for (unsigned long i=0; i<nBlocks/10 + 1; i++){
+      gen.tick(frames, context);
+      context.tick();
+    }
+
+    double best = -1;
+    for (unsigned int r=0; r<nRuns; r++){
+      double start = hostTimeSeconds();
+      for (unsigned long i=0; i<nBlocks; i++){
+        gen.tick(frames, context);
+        context.tick();
+      }
+      double elapsed = hostTimeSeconds() - start;
+      if (best < 0 || elapsed < best) best = elapsed;
+    }
+    return best;
+  }
+
+  // Test signal shared by effects, so every node processes the same kind of material
+  Generator testSignal(){
+    return SawtoothWaveBL().freq(110) * 0.5;
+  }
+
+  vector<BenchmarkCase> allCases(){
+
+    vector<BenchmarkCase> cases;
+
+    // Oscillators
+    cases.push_back(makeCase("SineWave", SineWave().freq(440)));
+    cases.push_back(makeCase("RectWaveBL", RectWaveBL().freq(440).pwm(0.3)));
+    cases.push_back(makeCase("SawtoothWaveBL", SawtoothWaveBL().freq(440)));
+    cases.push_back(makeCase("Noise", Noise()));
+    cases.push_back(makeCase("PinkNoise", PinkNoise()));
+
+    // Envelopes
+    cases.push_back(makeCase("ADSR", ADSR(0.01f, 0.1f, 0.5f, 0.2f).trigger(ControlMetro().bpm(240))));
+
+    // Filters and effects
+    Generator src;
+
+    src = testSignal();
+    cases.push_back(makeCase("LPF24", LPF24().input(src).cutoff(1000).Q(2), src));
+
+    src = testSignal();
+    cases.push_back(makeCase("BPF12", BPF12().input(src).cutoff(1000).Q(2), src));
+
+    src = testSignal();
+    cases.push_back(makeCase("HPF12", HPF12().input(src).cutoff(200), src));
+
+    src = testSignal();
+    cases.push_back(makeCase("SVFLPF", SVFLPF().input(src).cutoff(1000).Q(2), src));
+
+    // audio-rate sweep; includes the cost of the modulating sine
+    src = testSignal();
+    cases.push_back(makeCase("SVFLPFSweep", SVFLPF().input(src).cutoff(1000 + SineWave().freq(2) * 500).Q(2), src));
+
+    src = testSignal();
+    cases.push_back(makeCase("Reverb", Reverb().input(src), src));
+
+    src = testSignal();
+    cases.push_back(makeCase("Compressor", Compressor().input(src).threshold(0.25).ratio(4), src));
+
+    src = testSignal();
+    cases.push_back(makeCase("Limiter", Limiter().input(src), src));
+
+    src = testSignal();
+    cases.push_back(makeCase("BasicDelay", BasicDelay(0.25f, 0.5f).input(src).feedback(0.5), src));
+
+    // Audio-rate conversions
+    src = 60 + testSignal() * 12;
+    cases.push_back(makeCase("MidiToFreq", MidiToFreq().input(src), src));
+
+    src = testSignal() * 24 - 12;
+    cases.push_back(makeCase("DbToLinear", DbToLinear().input(src), src));
+
+    // Arithmetic chains. Audio-rate inputs, since constant ones are folded into a single value. The four
+    // inputs share one source, which computes once per block, so only the source's cost is subtracted.
+    src = testSignal();
+    Adder adder;
+    for (unsigned int i=0; i<4; i++){
+      adder.input(src);
+    }
+    cases.push_back(makeCase("Adder4", adder, src));
+
+    src = testSignal();
+    Multiplier multiplier;
+    for (unsigned int i=0; i<4; i++){
+      multiplier.input(src);
+    }
+    cases.push_back(makeCase("Multiplier4", multiplier, src));
+
+    return cases;
+  }
+
+}
+
+int main(int argc, const char * argv[]){
+
+  float secondsPerCase = argc > 1 ? (float)atof(argv[1]) : 10.0f;
+  string filter = argc > 2 ? argv[2] : "";
+  
+  // must be set before any generators are allocated
+  if (argc > 3) setSynthesisBlockSize((unsigned int)atoi(argv[3]));
+
+  // optionally force an instruction set for the vector kernels, e.g. to compare avx2 against sse2
+  if (argc > 4){
+    for (int level = SIMD_SCALAR; level <= SIMD_NEON; level++){
+      if (strcmp(argv[4], simdLevelName((SimdLevel)level)) == 0) setSimdLevel((SimdLevel)level);
+    }
+  }
+
+  const unsigned int nRuns = 3;
+  const unsigned long nBlocks = max(1, secondsPerCase * sampleRate() / synthesisBlockSize());
+  const unsigned long nSamples = nBlocks * synthesisBlockSize();
+  const TonicFloat rates[] = { 44100.f, 48000.f, 96000.f };
+  const unsigned int nRates = sizeof(rates)/sizeof(rates[0]);
+
+  vector<BenchmarkCase> cases = allCases();
+
+  printf("{\n");
+  printf("  \"blockSize\": %u,\n", synthesisBlockSize());
+  printf("  \"simd\": \"%s\",\n", simdLevelName(simdLevel()));
+  printf("  \"samplesPerRun\": %lu,\n", nSamples);
+  printf("  \"benchmarks\": [");
+
+  bool first = true;
+  for (unsigned int i=0; i<cases.size(); i++){
+
+    BenchmarkCase & bc = cases[i];
+    if (!filter.empty() && bc.name.find(filter) == string::npos) continue;
+
+    double seconds = timeGenerator(bc.node, nBlocks, nRuns);
+    if (bc.hasSource){
+      seconds = max(0, seconds - timeGenerator(bc.source, nBlocks, nRuns));
+    }
+
+    double nsPerSample = seconds * 1e9 / nSamples;
+
+    printf("%s\n    {\n", first ? "" : ",");
+    printf("      \"name\": \"%s\",\n", bc.name.c_str());
+    printf("      \"channels\": %u,\n", bc.node.isStereoOutput() ? 2 : 1);
+    printf("      \"nsPerSample\": %.3f,\n", nsPerSample);
+    printf("      \"voicesPerCore\": {");
+    for (unsigned int r=0; r<nRates; r++){
+      // one core has 1e9 ns per second to spend on rates[r] samples per voice
+      double voices = nsPerSample > 0 ? 1e9 / (nsPerSample * rates[r]) : 0;
+      printf("%s\"%d\": %.1f", r == 0 ? " " : ", ", (int)rates[r], voices);
+    }
+    printf(" }\n    }");
+    first = false;
+  }
+
+  printf("\n  ]\n}\n");
+
+  return 0;
+}
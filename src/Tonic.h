@@ -21,6 +21,8 @@
 // ------- Core Objects --------
 
 #include "Tonic/TonicCore.h"
+#include "Tonic/Arena.h"
+#include "Tonic/Random.h"
 #include "Tonic/TonicFrames.h"
 #include "Tonic/SampleTable.h"
 #include "Tonic/FixedValue.h"
@@ -51,6 +53,7 @@
 // Effects
 #include "Tonic/CombFilter.h"
 #include "Tonic/Filters.h"
+#include "Tonic/StateVariableFilter.h"
 #include "Tonic/StereoDelay.h"
 #include "Tonic/BasicDelay.h"
 #include "Tonic/Reverb.h"
@@ -63,6 +66,8 @@
 #include "Tonic/ADSR.h"
 #include "Tonic/RingBuffer.h"
 #include "Tonic/LFNoise.h"
+#include "Tonic/MidiToFreq.h"
+#include "Tonic/DbToLinear.h"
 
 // Non-Oscillator Audio Sources
 #include "Tonic/BufferPlayer.h"
@@ -96,4 +101,5 @@
 // -------- Util ---------
 
 #include "Tonic/AudioFileUtils.h"
+#include "Tonic/OfflineRenderer.h"
 #endif
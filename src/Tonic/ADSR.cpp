@@ -50,8 +50,8 @@ namespace Tonic { namespace Tonic_{
           lastValue = 0.f;
         }
         
-        segLength = attackTime * sampleRate();
-        pole = t60ToOnePoleCoef(attackTime);
+        segLength = attackTime * sampleRate_;
+        pole = t60ToOnePoleCoef(attackTime, sampleRate_);
         
         if (segLength == 0){
           lastValue = 1.0f;
@@ -67,8 +67,8 @@ namespace Tonic { namespace Tonic_{
         
       case DECAY:{
         
-        segLength = decayTime * sampleRate();
-        pole = t60ToOnePoleCoef(decayTime);
+        segLength = decayTime * sampleRate_;
+        pole = t60ToOnePoleCoef(decayTime, sampleRate_);
         
         targetValue = sustainLevelVal;
         
@@ -93,8 +93,8 @@ namespace Tonic { namespace Tonic_{
         
       case RELEASE:{
         
-        segLength = releaseTime * sampleRate();
-        pole = t60ToOnePoleCoef(releaseTime);
+        segLength = releaseTime * sampleRate_;
+        pole = t60ToOnePoleCoef(releaseTime, sampleRate_);
         
         targetValue = 0.f;
         
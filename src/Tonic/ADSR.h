@@ -83,6 +83,9 @@ namespace Tonic {
       //! Controls whether or not the envelope pauses on the SUSTAIN stage
       void setDoesSustain(ControlGenerator gen){doesSustain = gen;};
       
+      //! Silent between notes, in NEUTRAL state
+      bool canBecomeSilent(){ return true; };
+      
     };
     
     inline void ADSR_::computeSynthesisBlock(const SynthesisContext_ &context){
@@ -112,7 +115,8 @@ namespace Tonic {
         
       }
       
-      int samplesRemaining = kSynthesisBlockSize;
+      int samplesRemaining = synthesisBlockSize();
+      bool constant = false;
       
       while (samplesRemaining > 0)
       {
@@ -122,11 +126,14 @@ namespace Tonic {
           case NEUTRAL:
           case SUSTAIN:
           {
-            #ifdef USE_APPLE_ACCELERATE
-            vDSP_vfill(&lastValue, fdata, 1, samplesRemaining);
-            #else
-            std::fill(fdata, fdata + samplesRemaining, lastValue);
-            #endif
+            if (samplesRemaining == (int)synthesisBlockSize()){
+              // whole block is flat - silent when NEUTRAL
+              setConstantOutput(lastValue);
+              constant = true;
+            }
+            else{
+              vfill(lastValue, fdata, 1, samplesRemaining);
+            }
             
             samplesRemaining = 0;
           }
@@ -154,23 +161,10 @@ namespace Tonic {
               }
               else{
                 
-                #ifdef USE_APPLE_ACCELERATE
-                // starting point
-                lastValue += increment;
-                
-                // vector calculation
-                vDSP_vramp(&lastValue, &increment, fdata, 1, remainder);
-                
-                // end point
-                lastValue += increment*(remainder-1);
+                // uses algorithm out[n] = start + n * increment
+                vramp(lastValue + increment, increment, fdata, 1, remainder);
+                lastValue += increment*remainder;
                 fdata += remainder;
-                
-                #else
-                for (unsigned long i=0; i<remainder; i++){
-                  lastValue += increment;
-                  *fdata++ = lastValue;
-                }
-                #endif
               }
               
               segCounter += remainder;
@@ -201,22 +195,8 @@ namespace Tonic {
               }
               else{
                 // fill the rest of the ramp up
-                #ifdef USE_APPLE_ACCELERATE
-                // starting point
-                lastValue += increment;
-                
-                // vector calculation
-                vDSP_vramp(&lastValue, &increment, fdata, 1, samplesRemaining);
-                
-                // end point
-                lastValue += increment*(samplesRemaining-1);
-                
-                #else
-                for (int i=0; i<samplesRemaining; i++){
-                  lastValue += increment;
-                  *fdata++ = lastValue;
-                }
-                #endif
+                vramp(lastValue + increment, increment, fdata, 1, samplesRemaining);
+                lastValue += increment*samplesRemaining;
                 
               }
               
@@ -233,6 +213,10 @@ namespace Tonic {
         
       }
       
+      if (!constant){
+        isConstantOutput_ = false;
+      }
+      
     }
     
   }
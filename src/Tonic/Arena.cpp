@@ -0,0 +1,131 @@
+//
+//  Arena.cpp
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#include "Arena.h"
+#include <cstdlib>
+
+namespace Tonic {
+
+  namespace Tonic_ {
+
+    // Every block from allocate() is preceded by a header recording where it came from:
+    // the owning arena (NULL for the heap) and the start of the underlying allocation.
+    static const size_t kAllocationHeaderSize = 16;
+    static const size_t kAllocationAlignment = 16;
+
+    static TONIC_THREAD_LOCAL Arena_ * currentArena_ = NULL;
+
+    Arena_ * currentArena(){
+      return currentArena_;
+    }
+
+    void * allocate( size_t bytes, size_t alignment ){
+
+      alignment = std::max<size_t>(alignment, kAllocationAlignment);
+
+      // room for the header, plus enough slack to move the block up to the next aligned address
+      size_t rawBytes = bytes + kAllocationHeaderSize + alignment - 1;
+
+      Arena_ * arena = currentArena_;
+      char * raw;
+
+      if (arena){
+        raw = (char*)arena->allocate(rawBytes);
+        if (raw){
+          // each live block keeps its arena alive
+          arena->retain();
+        }
+      }
+      else{
+        raw = (char*)malloc(rawBytes);
+      }
+
+      if (!raw) return NULL;
+
+      uintptr_t address = ((uintptr_t)raw + kAllocationHeaderSize + alignment - 1) & ~(uintptr_t)(alignment - 1);
+      void ** block = (void**)address;
+      block[-1] = raw;
+      block[-2] = arena;
+      return block;
+    }
+
+    void deallocate( void * ptr ){
+
+      if (!ptr) return;
+
+      void ** block = (void**)ptr;
+      char * raw = (char*)block[-1];
+      Arena_ * arena = (Arena_*)block[-2];
+
+      if (arena){
+        // the last block may be freed on the audio thread, where freeing every chunk must be deferred
+        if (arena->release()) destroy(arena);
+      }
+      else{
+        free(raw);
+      }
+    }
+
+    // -- Arena_ --
+
+    Arena_::Arena_( size_t chunkSize ) :
+      chunkSize_(std::max<size_t>(chunkSize, 1024)),
+      cursor_(NULL),
+      remaining_(0),
+      bytesAllocated_(0),
+      bytesReserved_(0)
+    {}
+
+    Arena_::~Arena_(){
+      for (unsigned int i=0; i<chunks_.size(); i++){
+        free(chunks_[i]);
+      }
+    }
+
+    void * Arena_::allocate( size_t bytes ){
+
+      bytes = (bytes + kAllocationAlignment - 1) & ~(kAllocationAlignment - 1);
+
+      // large buffers (e.g. sample tables) get a chunk of their own, so they don't waste the current one
+      if (bytes > chunkSize_ / 4){
+        char * chunk = (char*)malloc(bytes);
+        if (!chunk) return NULL;
+        chunks_.push_back(chunk);
+        bytesAllocated_ += bytes;
+        bytesReserved_ += bytes;
+        return chunk;
+      }
+
+      if (bytes > remaining_){
+        char * chunk = (char*)malloc(chunkSize_);
+        if (!chunk) return NULL;
+        chunks_.push_back(chunk);
+        cursor_ = chunk;
+        remaining_ = chunkSize_;
+        bytesReserved_ += chunkSize_;
+      }
+
+      void * block = cursor_;
+      cursor_ += bytes;
+      remaining_ -= bytes;
+      bytesAllocated_ += bytes;
+      return block;
+    }
+
+  }
+
+  // -- ArenaScope --
+
+  ArenaScope::ArenaScope( Arena arena ) : previous_(Tonic_::currentArena_), arena_(arena) {
+    Tonic_::currentArena_ = arena_.rawArena();
+  }
+
+  ArenaScope::~ArenaScope(){
+    Tonic_::currentArena_ = previous_;
+  }
+
+}
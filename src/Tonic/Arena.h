@@ -0,0 +1,120 @@
+//
+//  Arena.h
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#ifndef TONIC_ARENA_H
+#define TONIC_ARENA_H
+
+#include "TonicCore.h"
+
+namespace Tonic {
+
+  namespace Tonic_ {
+
+    //! Bump allocator for the nodes and sample buffers of one synthesis graph.
+    /*!
+        Memory is handed out sequentially from large chunks, so a graph built in one go is
+        laid out contiguously in construction order. Individual frees only count down.
+        All chunks are returned to the heap at once, when the last allocation has been
+        freed and the last Arena handle is gone.
+     */
+    class Arena_ : public RefCounted_ {
+
+    protected:
+
+      size_t          chunkSize_;
+      vector<char*>   chunks_;
+      char *          cursor_;
+      size_t          remaining_;
+      size_t          bytesAllocated_;
+      size_t          bytesReserved_;
+
+    public:
+
+      Arena_( size_t chunkSize = 64 * 1024 );
+      ~Arena_();
+
+      // Arenas themselves always live on the heap, never inside another arena
+      static void * operator new( size_t bytes ) { return ::operator new(bytes); }
+      static void operator delete( void * ptr ) { ::operator delete(ptr); }
+
+      //! 16-byte aligned block of bytes. Not thread-safe: only the thread building the graph allocates.
+      void * allocate( size_t bytes );
+
+      //! Total bytes handed out, including alignment padding
+      size_t bytesAllocated() const { return bytesAllocated_; }
+
+      //! Total bytes reserved from the heap
+      size_t bytesReserved() const { return bytesReserved_; }
+
+    };
+
+    //! The arena new objects are allocated from on the calling thread, or NULL for the heap
+    Arena_ * currentArena();
+
+  }
+
+  //! Handle to an allocation arena. See ArenaScope.
+  class Arena : public TonicSmartPointer<Tonic_::Arena_> {
+
+  public:
+
+    //! New arena reserving memory in chunks of chunkSize bytes. Larger buffers get a chunk of their own.
+    Arena( size_t chunkSize = 64 * 1024 ) : TonicSmartPointer<Tonic_::Arena_>(new Tonic_::Arena_(chunkSize)) {}
+
+    Tonic_::Arena_ * rawArena() const { return obj; }
+
+    size_t bytesAllocated() const { return obj->bytesAllocated(); }
+    size_t bytesReserved() const { return obj->bytesReserved(); }
+
+  };
+
+  //! While in scope, Generators, ControlGenerators and their sample buffers created on this thread are allocated from an arena.
+  /*!
+      Building a graph inside a scope places its nodes and block buffers next to each other, in the order
+      they are created, instead of scattering them over the heap. Destroying the graph returns all of
+      its memory in one go, which avoids fragmenting the heap when voices are built and thrown away at runtime.
+
+      Objects keep working normally after the scope ends, and are still freed by reference counting.
+      Memory freed in an arena is not reused, so use one arena per graph build: once the scope and every
+      object built in it are gone, the arena returns all of its chunks at once (deferred like the objects
+      themselves if that happens on the audio thread, see collectGarbage()). Buffers that are resized
+      repeatedly (e.g. delay lines whose sample rate changes) are best created outside a scope.
+
+      Usage:
+
+      Synth synth;
+      {
+        ArenaScope scope;   // a new arena, owned by the graph built here
+        synth.setOutputGen( (SawtoothWave().freq(110) * ADSR().trigger(trig)) >> LPF24().cutoff(800) );
+      }
+
+      Pass the same Arena to several scopes to build one graph in several steps. Don't keep an Arena
+      handle around for longer than the graph, or its memory stays reserved after the graph is freed.
+
+      Scopes can be nested. The innermost one is used.
+   */
+  class ArenaScope {
+
+    Tonic_::Arena_ *  previous_;
+    Arena             arena_;
+
+    // not copyable
+    ArenaScope( const ArenaScope & );
+    ArenaScope & operator=( const ArenaScope & );
+
+  public:
+
+    ArenaScope( Arena arena = Arena() );
+    ~ArenaScope();
+
+    Arena arena() { return arena_; }
+
+  };
+
+}
+
+#endif
@@ -17,21 +17,14 @@ namespace Tonic{ namespace Tonic_ {
   //                 ADDER
   // -----------------------------------------
   
-  Adder_::Adder_(){
-    workSpace_.resize(kSynthesisBlockSize, 1, 0);
-  }
+  Adder_::Adder_(){}
   
   void Adder_::input(Generator generator){
-    inputs_.push_back( generator );
     if ( generator.isStereoOutput() && !this->isStereoOutput() ){
       setIsStereoOutput(true);
     }
-  }
-  
-  void Adder_::setIsStereoOutput( bool stereo )
-  {
-    Generator_::setIsStereoOutput(stereo);
-    workSpace_.resize(kSynthesisBlockSize, stereo ? 2 : 1, 0);
+    inputs_.push_back( TONIC_MOVE(generator) );
+    inputsChanged();
   }
 
   
@@ -39,16 +32,15 @@ namespace Tonic{ namespace Tonic_ {
   //                SUBTRACTOR
   // -----------------------------------------
   
-  Subtractor_::Subtractor_(){
-    workSpace_.resize(kSynthesisBlockSize, 1, 0);
-  }
+  Subtractor_::Subtractor_(){}
   
   void Subtractor_::setLeft(Generator arg){
     if (arg.isStereoOutput() && !isStereoOutput())
     {
       setIsStereoOutput(true);
     }
-    left_ = arg;
+    left_ = TONIC_MOVE(arg);
+    inputsChanged();
   }
   
   void Subtractor_::setRight(Generator arg){
@@ -56,13 +48,8 @@ namespace Tonic{ namespace Tonic_ {
     {
       setIsStereoOutput(true);
     }
-    right_ = arg;
-  }
-  
-  void Subtractor_::setIsStereoOutput( bool stereo )
-  {
-    Generator_::setIsStereoOutput(stereo);
-    workSpace_.resize(kSynthesisBlockSize, stereo ? 2 : 1, 0);
+    right_ = TONIC_MOVE(arg);
+    inputsChanged();
   }
 
   
@@ -70,38 +57,37 @@ namespace Tonic{ namespace Tonic_ {
   //                MULTIPLIER
   // -----------------------------------------
   
-  Multiplier_::Multiplier_(){
-    workSpace_.resize(kSynthesisBlockSize, 1, 0);
-  }
+  Multiplier_::Multiplier_() : gatesInputs_(false) {}
   
   void Multiplier_::input(Generator generator){
-    inputs_.push_back(generator);
     if ( generator.isStereoOutput() && !isStereoOutput() ){
       setIsStereoOutput(true);
     }
+    inputs_.push_back(TONIC_MOVE(generator));
+    inputsChanged();
   }
   
-  void Multiplier_::setIsStereoOutput( bool stereo )
-  {
-    Generator_::setIsStereoOutput(stereo);
-    workSpace_.resize(kSynthesisBlockSize, stereo ? 2 : 1, 0);
+  void Multiplier_::setGatesInputs(bool gates){
+    if (gates != gatesInputs_){
+      gatesInputs_ = gates;
+      inputsChanged();
+    }
   }
-  
+
   
   // -----------------------------------------
   //                DIVIDER
   // -----------------------------------------
   
-  Divider_::Divider_(){
-    workSpace_.resize(kSynthesisBlockSize, 1, 0);
-  }
+  Divider_::Divider_(){}
   
   void Divider_::setLeft(Generator arg){
     if (arg.isStereoOutput() && !isStereoOutput())
     {
       setIsStereoOutput(true);
     }
-    left_ = arg;
+    left_ = TONIC_MOVE(arg);
+    inputsChanged();
   }
   
   void Divider_::setRight(Generator arg){
@@ -109,13 +95,8 @@ namespace Tonic{ namespace Tonic_ {
     {
       setIsStereoOutput(true);
     }
-    right_ = arg;
+    right_ = TONIC_MOVE(arg);
+    inputsChanged();
   }
-  
-  void Divider_::setIsStereoOutput( bool stereo )
-  {
-    Generator_::setIsStereoOutput(stereo);
-    workSpace_.resize(kSynthesisBlockSize, stereo ? 2 : 1, 0);
-  }
-  
+    
 }}
\ No newline at end of file
@@ -16,6 +16,23 @@
 
 namespace Tonic {
   
+  namespace Tonic_{
+    
+    //! Input block in a form the TonicFrames arithmetic operators can combine with a block laid out like workspace.
+    /*!
+        Matching and mono inputs are read in place (the operators spread mono across all channels),
+        anything else is converted into workspace first. Callers borrow workspace as ScratchFrames_.
+     */
+    inline const TonicFrames & arithmeticOperand( const TonicFrames & frames, TonicFrames & workspace ){
+      if (frames.channels() == 1 || frames.channels() == workspace.channels()){
+        return frames;
+      }
+      workspace.copy(frames);
+      return workspace;
+    }
+    
+  }
+  
   // -----------------------------------------
   //                 ADDER
   // -----------------------------------------
@@ -26,7 +43,6 @@ namespace Tonic {
       
     protected:
       vector<Generator> inputs_;
-      TonicFrames workSpace_;
       
       void computeSynthesisBlock( const SynthesisContext_ &context );
 
@@ -34,8 +50,19 @@ namespace Tonic {
       
       Adder_();
       
+      void appendInputs( vector<Generator_*> & inputs ){
+        for (unsigned int i=0; i<inputs_.size(); i++) inputs.push_back(inputs_[i].rawGenerator());
+      };
+      
+      //! A sum is silent when all its inputs are
+      bool canBecomeSilent(){
+        for (unsigned int i=0; i<inputs_.size(); i++){
+          if (!inputs_[i].rawGenerator()->canBecomeSilent()) return false;
+        }
+        return true;
+      }
+
       void input(Generator generator);
-      void setIsStereoOutput( bool stereo );
       
       Generator getInput(unsigned int index) { return inputs_[index]; };
       unsigned int numInputs() { return (unsigned int)inputs_.size(); };
@@ -44,13 +71,44 @@ namespace Tonic {
     
     inline void Adder_::computeSynthesisBlock( const SynthesisContext_ &context ){
       
-      TonicFloat *framesData =  &outputFrames_[0];
+      if (inputs_.empty()){
+        setConstantOutput(0);
+        return;
+      }
       
-      memset(framesData, 0, sizeof(TonicFloat) * outputFrames_.size());
+      // Constant inputs are summed as scalars. The first non-constant input is copied in,
+      // the rest are added directly from their output blocks, in the same order as inputs.
+      bool constant = true;
+      TonicFloat sum = 0;
+      
+      for (unsigned int j=0; j < inputs_.size(); j++) {
+        
+        const TonicFrames & frames = inputs_[j].output(context);
+        
+        if (inputs_[j].isConstantOutput()){
+          if (constant){
+            sum = (j == 0) ? frames[0] : sum + frames[0];
+          }
+          else{
+            outputFrames_ += frames[0];
+          }
+        }
+        else if (constant){
+          outputFrames_.copy(frames);
+          if (j > 0) outputFrames_ += sum;
+          constant = false;
+        }
+        else{
+          ScratchFrames_ workspace(context, outputFrames_.channels());
+          outputFrames_ += arithmeticOperand(frames, *workspace);
+        }
+      }
       
-      for (int j =0; j < inputs_.size(); j++) {
-        inputs_[j].tick(workSpace_, context);
-        outputFrames_ += workSpace_; // add each sample in frames to each sample in workspace
+      if (constant){
+        setConstantOutput(sum);
+      }
+      else{
+        isConstantOutput_ = false;
       }
       
     }
@@ -61,7 +119,7 @@ namespace Tonic {
   public:
     
     Adder input(Generator input){
-      gen()->input(input);
+      gen()->input(TONIC_MOVE(input));
       return *this;
     }
     
@@ -79,8 +137,8 @@ namespace Tonic {
   
   static Adder operator + (Generator a, Generator b){
     Adder add;
-    add.input(a);
-    add.input(b);
+    add.input(TONIC_MOVE(a));
+    add.input(TONIC_MOVE(b));
     return add;
   }
   
@@ -88,14 +146,14 @@ namespace Tonic {
   static Adder operator + (float a, Generator b){
     Adder add;
     add.input(FixedValue(a));
-    add.input(b);
+    add.input(TONIC_MOVE(b));
     return add;
   }
   
   
   static Adder operator + (Generator a, float b){
     Adder add;
-    add.input(a);
+    add.input(TONIC_MOVE(a));
     add.input(FixedValue(b));
     return add;
   }
@@ -133,7 +191,6 @@ namespace Tonic {
       
       Generator left_;
       Generator right_;
-      TonicFrames workSpace_;
       
       void computeSynthesisBlock( const SynthesisContext_ &context );
       
@@ -141,16 +198,35 @@ namespace Tonic {
       
       Subtractor_();
       
+      void appendInputs( vector<Generator_*> & inputs ){
+        inputs.push_back(left_.rawGenerator());
+        inputs.push_back(right_.rawGenerator());
+      };
+
       void setLeft(Generator arg);
       void setRight(Generator arg);
-      void setIsStereoOutput( bool stereo );
       
     };
     
     inline void Subtractor_::computeSynthesisBlock(const SynthesisContext_ &context){
-      left_.tick(outputFrames_, context);
-      right_.tick(workSpace_, context);
-      outputFrames_ -= workSpace_;
+      
+      const TonicFrames & left = left_.output(context);
+      const TonicFrames & right = right_.output(context);
+      
+      if (left_.isConstantOutput() && right_.isConstantOutput()){
+        setConstantOutput(left[0] - right[0]);
+        return;
+      }
+      
+      outputFrames_.copy(left);
+      if (right_.isConstantOutput()){
+        outputFrames_ -= right[0];
+      }
+      else{
+        ScratchFrames_ workspace(context, outputFrames_.channels());
+        outputFrames_ -= arithmeticOperand(right, *workspace);
+      }
+      isConstantOutput_ = false;
     }
     
   }
@@ -167,21 +243,21 @@ namespace Tonic {
   
   static Subtractor operator - (Generator a, Generator b){
     Subtractor sub;
-    sub.left(a);
-    sub.right(b);
+    sub.left(TONIC_MOVE(a));
+    sub.right(TONIC_MOVE(b));
     return sub;
   }
   
   static Subtractor operator - (float a, Generator b){
     Subtractor sub;
     sub.left(FixedValue(a));
-    sub.right(b);
+    sub.right(TONIC_MOVE(b));
     return sub;
   }
   
   static Subtractor operator - (Generator a, float b){
     Subtractor sub;
-    sub.left(a);
+    sub.left(TONIC_MOVE(a));
     sub.right(FixedValue(b));
     return sub;
   }
@@ -206,7 +282,7 @@ namespace Tonic {
       
     protected:
       vector<Generator> inputs_;
-      TonicFrames workSpace_;
+      bool              gatesInputs_;
       
       void computeSynthesisBlock( const SynthesisContext_ & context );
       
@@ -214,8 +290,47 @@ namespace Tonic {
 
       Multiplier_();
       
+      // When gating, the other inputs aren't computed at all while an input that can go silent is silent,
+      // so only those inputs are scheduled. The rest are computed on demand while the product is audible.
+      void appendInputs( vector<Generator_*> & inputs ){
+        bool gated = false;
+        if (gatesInputs_){
+          for (unsigned int i=0; i<inputs_.size(); i++){
+            if (inputs_[i].rawGenerator()->canBecomeSilent()){
+              inputs.push_back(inputs_[i].rawGenerator());
+              gated = true;
+            }
+          }
+        }
+        if (!gated){
+          for (unsigned int i=0; i<inputs_.size(); i++) inputs.push_back(inputs_[i].rawGenerator());
+        }
+      };
+      
+      void appendUnscheduledInputs( vector<Generator_*> & inputs ){
+        if (!gatesInputs_ || !canBecomeSilent()) return;
+        for (unsigned int i=0; i<inputs_.size(); i++){
+          if (!inputs_[i].rawGenerator()->canBecomeSilent()) inputs.push_back(inputs_[i].rawGenerator());
+        }
+      };
+      
+      //! A product is silent when any of its inputs is
+      bool canBecomeSilent(){
+        for (unsigned int i=0; i<inputs_.size(); i++){
+          if (inputs_[i].rawGenerator()->canBecomeSilent()) return true;
+        }
+        return false;
+      }
+
       void input(Generator generator);
-      void setIsStereoOutput( bool stereo );
+      
+      //! Skip the other inputs entirely while an input that can go silent is silent. Off by default.
+      /*!
+          Skipped inputs don't advance: oscillators keep their phase, and ControlGenerators that only
+          they tick aren't ticked, so counters, steppers and trigger filters in them miss the triggers
+          that arrive while the product is silent.
+       */
+      void setGatesInputs(bool gates);
       
       Generator getInput(unsigned int index) { return inputs_[index]; };
       unsigned int numInputs() { return (unsigned int)inputs_.size(); };
@@ -225,15 +340,60 @@ namespace Tonic {
     
     inline void Multiplier_::computeSynthesisBlock( const SynthesisContext_ & context ){
       
-      memset(&outputFrames_[0], 0, sizeof(TonicFloat) * outputFrames_.size());
+      // If an input is silent (an idle envelope, typically) the product is too. When gating, the other
+      // inputs are skipped entirely - stateful ones pause until the product is audible again. Otherwise
+      // they are still computed, so everything they tick keeps running, but not multiplied.
+      // Forced output recomputes on every read, so inputs must then be read exactly once, in order.
+      if (!context.forceNewOutput){
+        for (unsigned int i = 0; i < inputs_.size(); i++){
+          if (inputs_[i].rawGenerator()->canBecomeSilent()){
+            inputs_[i].output(context);
+            if (inputs_[i].isSilentOutput()){
+              if (!gatesInputs_){
+                for (unsigned int j = 0; j < inputs_.size(); j++){
+                  inputs_[j].output(context);
+                }
+              }
+              setConstantOutput(0);
+              return;
+            }
+          }
+        }
+      }
       
-      // for the first generator, store the value in the block
-      inputs_[0].tick(outputFrames_, context);
+      // Constant inputs are multiplied as scalars. The first non-constant input is copied in,
+      // the rest are multiplied directly from their output blocks, in the same order as inputs.
+      bool constant = true;
+      TonicFloat product = 0;
+      
+      for(unsigned int i = 0; i < inputs_.size(); i++) {
+        
+        const TonicFrames & frames = inputs_[i].output(context);
+        
+        if (inputs_[i].isConstantOutput()){
+          if (constant){
+            product = (i == 0) ? frames[0] : product * frames[0];
+          }
+          else{
+            outputFrames_ *= frames[0];
+          }
+        }
+        else if (constant){
+          outputFrames_.copy(frames);
+          if (i > 0) outputFrames_ *= product;
+          constant = false;
+        }
+        else{
+          ScratchFrames_ workspace(context, outputFrames_.channels());
+          outputFrames_ *= arithmeticOperand(frames, *workspace);
+        }
+      }
       
-      // for additional generators, use the workspace stkframes for tick, and multiply it into the frames argument
-      for(int i = 1; i < inputs_.size(); i++) {
-        inputs_[i].tick(workSpace_, context);
-        outputFrames_ *= workSpace_;
+      if (constant){
+        setConstantOutput(product);
+      }
+      else{
+        isConstantOutput_ = false;
       }
       
     }
@@ -243,7 +403,17 @@ namespace Tonic {
   class Multiplier : public TemplatedGenerator<Tonic_::Multiplier_>{
   public:
     Multiplier input(Generator inputSource){
-      gen()->input(inputSource);
+      gen()->input(TONIC_MOVE(inputSource));
+      return *this;
+    }
+    
+    //! While an input that can go silent (e.g. an idle ADSR) is silent, don't compute the other inputs. Off by default.
+    /*!
+        (SineWave() * env).gateInputs() costs almost nothing while env is idle. ControlGenerators ticked
+        only by the skipped inputs aren't ticked either, so leave this off if they need to see every trigger.
+     */
+    Multiplier gateInputs(bool gates = true){
+      gen()->setGatesInputs(gates);
       return *this;
     }
     
@@ -259,8 +429,8 @@ namespace Tonic {
   
   static Multiplier operator*(Generator a, Generator b){
     Multiplier mult;
-    mult.input(a);
-    mult.input(b);
+    mult.input(TONIC_MOVE(a));
+    mult.input(TONIC_MOVE(b));
     return mult;
   }
   
@@ -304,7 +474,6 @@ namespace Tonic {
     protected:
       Generator left_;
       Generator right_;
-      TonicFrames workSpace_;
       
       void computeSynthesisBlock( const SynthesisContext_ &context );
       
@@ -312,17 +481,35 @@ namespace Tonic {
 
       Divider_();
       
+      void appendInputs( vector<Generator_*> & inputs ){
+        inputs.push_back(left_.rawGenerator());
+        inputs.push_back(right_.rawGenerator());
+      };
+
       void setLeft(Generator arg);
       void setRight(Generator arg);
-      void setIsStereoOutput( bool stereo );
       
     };
     
     inline void Divider_::computeSynthesisBlock(const SynthesisContext_ &context){
-      left_.tick(outputFrames_, context);
-      right_.tick(workSpace_, context);
-      outputFrames_ /= workSpace_;
       
+      const TonicFrames & left = left_.output(context);
+      const TonicFrames & right = right_.output(context);
+      
+      if (left_.isConstantOutput() && right_.isConstantOutput()){
+        setConstantOutput(left[0] / right[0]);
+        return;
+      }
+      
+      outputFrames_.copy(left);
+      if (right_.isConstantOutput()){
+        outputFrames_ /= right[0];
+      }
+      else{
+        ScratchFrames_ workspace(context, outputFrames_.channels());
+        outputFrames_ /= arithmeticOperand(right, *workspace);
+      }
+      isConstantOutput_ = false;
     }
     
   }
@@ -339,21 +526,21 @@ namespace Tonic {
   
   static Divider operator / (Generator a, Generator b){
     Divider div;
-    div.left(a);
-    div.right(b);
+    div.left(TONIC_MOVE(a));
+    div.right(TONIC_MOVE(b));
     return div;
   }
   
   static Divider operator / (float a, Generator b){
     Divider div;
     div.left(FixedValue(a));
-    div.right(b);
+    div.right(TONIC_MOVE(b));
     return div;
   }
   
   static Divider operator / (Generator a, float b){
     Divider div;
-    div.left(a);
+    div.left(TONIC_MOVE(a));
     div.right(FixedValue(b));
     return div;
   }
@@ -8,6 +8,7 @@
 
 #include "AudioFileUtils.h"
 #include <fstream>
+#include <sys/stat.h>
 
 #ifdef __APPLE__
 #include <AudioToolbox/AudioToolbox.h>
@@ -37,7 +38,7 @@ namespace Tonic {
   }
   
 
-  SampleTable loadAudioFile(string path, int numChannels){
+  static SampleTable decodeAudioFile(string path, int numChannels){
   
     static const int BYTES_PER_SAMPLE = sizeof(TonicFloat);
     
@@ -92,7 +93,7 @@ namespace Tonic {
   
   #else
   
-  SampleTable loadAudioFile(string path, int numChannels)
+  static SampleTable decodeAudioFile(string path, int numChannels)
   {
 
       #define FRAMES_PER_BUFFER	1024
@@ -152,4 +153,189 @@ namespace Tonic {
   
   #endif
   
+  // -- Sample cache --
+  
+  // Decoded samples are cached on disk as a 64-byte header followed by interleaved 32-bit floats,
+  // so the sample data is aligned in the mapped file. Host byte order: cache files are not portable.
+  
+  static const char         kSampleCacheMagic[4] = {'T', 'S', 'C', '1'};
+  static const size_t       kSampleCacheHeaderSize = 64;
+  
+  struct SampleCacheHeader {
+    char        magic[4];
+    TonicUInt32 channels;
+    uint64_t    frames;
+    uint64_t    sourceSize;   // size and modification time of the decoded file, to detect changes
+    int64_t     sourceModified;
+  };
+  
+  class SampleCache {
+    
+  public:
+    
+    TONIC_MUTEX_T               mutex;
+    string                      directory;
+    std::map<string, SampleTable> tables;
+    
+    SampleCache(){
+      TONIC_MUTEX_INIT(mutex);
+    }
+    
+  };
+  
+  static SampleCache & sampleCache(){
+    static SampleCache cache;
+    return cache;
+  }
+  
+  // Drop the tables only the cache still references. Call with the cache mutex locked: nothing else can
+  // get a new reference to such a table then, so it can't be picked up again after the check.
+  static void pruneSampleCache(SampleCache & cache){
+    std::map<string, SampleTable>::iterator it = cache.tables.begin();
+    while (it != cache.tables.end()){
+      if (it->second.isUnique()){
+        cache.tables.erase(it++);
+      }
+      else{
+        it++;
+      }
+    }
+  }
+  
+  // Name of the cache file for a source path, from a 64-bit FNV-1a hash of the path
+  static string sampleCachePath(const string & directory, const string & key){
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i=0; i<key.size(); i++){
+      hash = (hash ^ (unsigned char)key[i]) * 1099511628211ULL;
+    }
+    char name[32];
+    sprintf(name, "%016llx.tsc", (unsigned long long)hash);
+    return directory + "/" + name;
+  }
+  
+  static bool readSourceInfo(const string & path, SampleCacheHeader & header){
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) return false;
+    header.sourceSize = (uint64_t)info.st_size;
+    header.sourceModified = (int64_t)info.st_mtime;
+    return true;
+  }
+  
+  // Map (or, without mmap, read) a cache file if it is complete and matches the current source file
+  static bool loadSampleCacheFile(const string & cachePath, const SampleCacheHeader & source, SampleTable & table){
+    
+    std::ifstream in(cachePath.c_str(), std::ios::in | std::ios::binary);
+    if (!in.is_open()) return false;
+    
+    SampleCacheHeader header;
+    in.read((char*)&header, sizeof(header));
+    if (!in.good() ||
+        memcmp(header.magic, kSampleCacheMagic, 4) != 0 ||
+        header.channels < 1 || header.channels > 2 ||
+        header.sourceSize != source.sourceSize ||
+        header.sourceModified != source.sourceModified){
+      return false;
+    }
+    
+    size_t dataBytes = (size_t)header.frames * header.channels * sizeof(TonicFloat);
+    in.seekg(0, std::ios::end);
+    if ((size_t)in.tellg() != kSampleCacheHeaderSize + dataBytes) return false;
+    
+    table = SampleTable(0, 0);
+    if (table.mapFile(cachePath, kSampleCacheHeaderSize, (unsigned long)header.frames, header.channels)){
+      return true;
+    }
+    
+    table.resize((unsigned int)header.frames, header.channels);
+    in.seekg(kSampleCacheHeaderSize, std::ios::beg);
+    in.read((char*)table.dataPointer(), dataBytes);
+    return in.good();
+  }
+  
+  static void writeSampleCacheFile(const string & cachePath, SampleCacheHeader header, SampleTable & table){
+    
+    memcpy(header.magic, kSampleCacheMagic, 4);
+    header.channels = table.channels();
+    header.frames = table.frames();
+    
+    char headerBytes[kSampleCacheHeaderSize];
+    memset(headerBytes, 0, kSampleCacheHeaderSize);
+    memcpy(headerBytes, &header, sizeof(header));
+    
+    // write to a temporary file and rename it into place, so a concurrent or interrupted
+    // load never sees a partial cache file
+    string tempPath = cachePath + ".tmp";
+    std::ofstream out(tempPath.c_str(), std::ios::out | std::ios::binary);
+    if (!out.is_open()){
+      warning("Sample cache: could not write " + tempPath);
+      return;
+    }
+    out.write(headerBytes, kSampleCacheHeaderSize);
+    out.write((const char*)table.dataPointer(), table.size() * sizeof(TonicFloat));
+    out.close();
+    
+    if (out.fail() || rename(tempPath.c_str(), cachePath.c_str()) != 0){
+      warning("Sample cache: could not write " + cachePath);
+      remove(tempPath.c_str());
+    }
+  }
+  
+  SampleTable loadAudioFile(string path, int numChannels){
+    
+    SampleCache & cache = sampleCache();
+    TONIC_MUTEX_LOCK(cache.mutex);
+    
+    pruneSampleCache(cache);
+    
+    std::ostringstream keyStream;
+    keyStream << numChannels << ":" << path;
+    string key = keyStream.str();
+    
+    std::map<string, SampleTable>::iterator it = cache.tables.find(key);
+    if (it != cache.tables.end()){
+      SampleTable table = it->second;
+      TONIC_MUTEX_UNLOCK(cache.mutex);
+      return table;
+    }
+    
+    SampleTable table;
+    SampleCacheHeader source;
+    bool useDiskCache = !cache.directory.empty() && readSourceInfo(path, source);
+    string cachePath = useDiskCache ? sampleCachePath(cache.directory, key) : "";
+    
+    if (!useDiskCache || !loadSampleCacheFile(cachePath, source, table)){
+      
+      table = decodeAudioFile(path, numChannels);
+      
+      if (useDiskCache){
+        writeSampleCacheFile(cachePath, source, table);
+        
+        // use the file we just wrote, so the decoded copy does not stay resident
+        SampleTable mapped = SampleTable(0, 0);
+        if (mapped.mapFile(cachePath, kSampleCacheHeaderSize, table.frames(), table.channels())){
+          table = mapped;
+        }
+      }
+    }
+    
+    cache.tables[key] = table;
+    
+    TONIC_MUTEX_UNLOCK(cache.mutex);
+    return table;
+  }
+  
+  void setSampleCacheDirectory(string directory){
+    SampleCache & cache = sampleCache();
+    TONIC_MUTEX_LOCK(cache.mutex);
+    cache.directory = directory;
+    TONIC_MUTEX_UNLOCK(cache.mutex);
+  }
+  
+  void clearSampleCache(){
+    SampleCache & cache = sampleCache();
+    TONIC_MUTEX_LOCK(cache.mutex);
+    cache.tables.clear();
+    TONIC_MUTEX_UNLOCK(cache.mutex);
+  }
+  
 }
@@ -13,8 +13,28 @@
 
 namespace Tonic {
   
+  //! Decode an audio file into a SampleTable.
+  /*!
+      Tables are shared: loading the same path with the same numChannels while the table from an
+      earlier load is still in use returns the same SampleTable instance, so changes made to one are
+      seen by all. The cache doesn't keep tables alive: once nothing else references a table, it is
+      dropped on the next load. See clearSampleCache().
+   
+      If a cache directory is set, the decoded samples are also written there, and later loads
+      (including in later runs) memory-map the cache file instead of decoding again.
+   */
   SampleTable loadAudioFile(string path, int numChannels = 2);
   
+  //! Directory for decoded sample cache files. An empty string (the default) disables the disk cache.
+  /*!
+      Cache files are rebuilt when the size or modification time of their source file changes.
+      The directory must already exist.
+   */
+  void setSampleCacheDirectory(string directory);
+  
+  //! Stop sharing the tables loaded so far. Tables still in use elsewhere remain valid.
+  void clearSampleCache();
+  
 }
 
 #endif /* defined(__TonicLib__AudioFileUtils__) */
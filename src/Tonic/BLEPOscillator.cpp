@@ -27,7 +27,6 @@ namespace Tonic { namespace Tonic_{
       memset(ringBuf_, 0, (lBuffer_+1)*sizeof(TonicFloat));
     
       freqGen_ = FixedValue(440);
-      freqFrames_.resize(kSynthesisBlockSize, 1, 0);
   }
   
   BLEPOscillator_::~BLEPOscillator_()
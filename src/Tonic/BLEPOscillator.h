@@ -35,7 +35,6 @@ namespace Tonic {
       
       // Input generators
       Generator freqGen_;
-      TonicFrames freqFrames_;
       
       // TODO: Hardsync?
       
@@ -91,7 +90,9 @@ namespace Tonic {
       BLEPOscillator_();
       ~BLEPOscillator_();
       
-      void setFreqGen(Generator gen) { freqGen_ = gen; };
+      void appendInputs( vector<Generator_*> & inputs ) { inputs.push_back(freqGen_.rawGenerator()); };
+
+      void setFreqGen(Generator gen) { freqGen_ = gen; inputsChanged(); };
       
     };
     
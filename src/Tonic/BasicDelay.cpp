@@ -11,8 +11,6 @@
 namespace Tonic { namespace Tonic_{
   
   BasicDelay_::BasicDelay_() {
-    delayTimeFrames_.resize(kSynthesisBlockSize, 1, 0);
-    fbkFrames_.resize(kSynthesisBlockSize, 1, 0);
     delayTimeGen_ = FixedValue(0);
     fbkGen_ = FixedValue(0);
     setDryLevelGen(FixedValue(0.5));
@@ -37,6 +35,9 @@ namespace Tonic { namespace Tonic_{
     if (maxDelayTime <= 0) maxDelayTime = delayTime * 1.5;
     delayLine_.initialize(maxDelayTime, 1);
     delayTimeGen_ = FixedValue(delayTime);
+    
+    // sleep only after a full pass through the delay line has decayed
+    setSilenceDetection(maxDelayTime, silenceThreshold_);
   }
   
 } // Namespace Tonic_
@@ -24,46 +24,52 @@ namespace Tonic {
     protected:
       
       Generator delayTimeGen_;
-      TonicFrames delayTimeFrames_;
-      
       Generator fbkGen_;
-      TonicFrames fbkFrames_;
 
       DelayLine delayLine_;
       
       void computeSynthesisBlock( const SynthesisContext_ &context );
       
+      void sampleRateChanged(){ delayLine_.setSampleRate(sampleRate_); };
+      
     public:
       
       BasicDelay_();
       ~BasicDelay_();
       
+      void appendInputs( vector<Generator_*> & inputs ){
+        WetDryEffect_::appendInputs(inputs);
+        inputs.push_back(delayTimeGen_.rawGenerator());
+        inputs.push_back(fbkGen_.rawGenerator());
+      };
+
       // Overridden so output channel layout follows input channel layout
       void setInput( Generator input );
       
       void initialize(float delayTime, float maxDelayTime);
       
-      void setDelayTimeGen( Generator gen ) { delayTimeGen_ = gen; };
+      void setDelayTimeGen( Generator gen ) { delayTimeGen_ = gen; inputsChanged(); };
             
-      void setFeedbackGen( Generator gen ) { fbkGen_ = gen; };
+      void setFeedbackGen( Generator gen ) { fbkGen_ = gen; inputsChanged(); };
             
     };
     
     inline void BasicDelay_::computeSynthesisBlock(const SynthesisContext_ &context){
       
-      delayTimeGen_.tick(delayTimeFrames_, context);
-      fbkGen_.tick(fbkFrames_, context);
+      // modulations are read directly from their generators' output blocks
+      ScratchFrames_ delayTimeFrames(context, 1);
+      ScratchFrames_ fbkFrames(context, 1);
+      const TonicFloat *delptr = &delayTimeGen_.output(context, *delayTimeFrames)[0];
+      const TonicFloat *fbkptr = &fbkGen_.output(context, *fbkFrames)[0];
       
       // input->output always has same channel layout
       unsigned int nChannels = isStereoInput() ? 2 : 1;
       
       TonicFloat fbk, outSamp;
-      TonicFloat *dryptr = &dryFrames_[0];
+      const TonicFloat *dryptr = &dryInput()[0];
       TonicFloat *outptr = &outputFrames_[0];
-      TonicFloat *fbkptr = &fbkFrames_[0];
-      TonicFloat *delptr = &delayTimeFrames_[0];
       
-      for (unsigned int i=0; i<kSynthesisBlockSize; i++){
+      for (unsigned int i=0; i<synthesisBlockSize(); i++){
         
         // Don't clamp feeback - be careful! Negative feedback could be interesting.
         fbk = *fbkptr++;
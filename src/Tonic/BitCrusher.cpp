@@ -17,13 +17,13 @@ namespace Tonic{
     
       void BitCrusher_::setInput( Generator input ) {
         input_ = input;
+        inputsChanged();
         setIsStereoInput(input_.isStereoOutput());
       };
     
       void BitCrusher_::setIsStereoInput( bool stereo ) {
         if (stereo != isStereoInput_){
-          dryFrames_.resize(kSynthesisBlockSize, stereo ? 2 : 1, 0);
-          outputFrames_.resize(kSynthesisBlockSize, stereo ? 2 : 1, 0);
+          outputFrames_.resize(synthesisBlockSize(), stereo ? 2 : 1, 0);
         }
         isStereoInput_ = stereo;
         isStereoOutput_ = stereo;
@@ -36,7 +36,7 @@ namespace Tonic {
     inline void BitCrusher_::computeSynthesisBlock(const SynthesisContext_ &context){
       
       TonicFloat *synthBlockWriteHead = &outputFrames_[0];
-      TonicFloat *dryFramesReadHead = &dryFrames_[0];
+      const TonicFloat *dryFramesReadHead = &dryInput()[0];
       
       unsigned int nSamples = (unsigned int)outputFrames_.size();
       float bitDepthValue = clamp(bitDepth.tick(context).value, 0, 16) ;
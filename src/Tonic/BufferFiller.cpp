@@ -18,11 +18,29 @@ namespace Tonic {
     BufferFiller_::BufferFiller_() :  bufferReadPosition_(0) {
       TONIC_MUTEX_INIT(mutex_);
       setIsStereoOutput(true);
+      synthContext_.scratch = &scratch_;
     }
     
     BufferFiller_::~BufferFiller_(){
       TONIC_MUTEX_DESTROY(mutex_);
     }
     
+    void BufferFiller_::setProfilingEnabled(bool enabled){
+      if (enabled && !profiler_.hasStorage()){
+        profiler_.reserve(Profiler_::kDefaultCapacity);
+      }
+      if (enabled){
+        profiler_.prepare(this);
+      }
+      synthContext_.profiler = enabled ? &profiler_ : NULL;
+    }
+    
+    void BufferFiller_::resetProfile(){
+      profiler_.reset();
+      if (isProfilingEnabled()){
+        profiler_.prepare(this);
+      }
+    }
+    
   }
 }
\ No newline at end of file
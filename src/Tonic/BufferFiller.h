@@ -29,12 +29,18 @@ namespace Tonic{
       
     private:
       
-      unsigned long               bufferReadPosition_;
+      unsigned int                bufferReadPosition_; // frame index into outputFrames_
       TONIC_MUTEX_T               mutex_;
       
+      // copy nFrames of outputFrames_ starting at bufferReadPosition_ to the output, converting channel layout
+      void readInterleaved(float *outData, unsigned int nFrames, unsigned int numChannels);
+      void readPlanar(float **outData, unsigned int offset, unsigned int nFrames, unsigned int numChannels);
+      
     protected:
       
       Tonic_::SynthesisContext_   synthContext_;
+      Tonic_::Profiler_           profiler_;
+      Tonic_::ScratchStack_       scratch_;
       
     public:
       
@@ -52,14 +58,33 @@ namespace Tonic{
       void tick( TonicFrames& frames );
       
       void fillBufferOfFloats(float *outData,  unsigned int numFrames, unsigned int numChannels);
+      
+      void fillPlanarBufferOfFloats(float **outData, unsigned int numFrames, unsigned int numChannels);
+      
+      // profiling - lock the mutex before calling these from outside the audio thread
+      void setProfilingEnabled(bool enabled);
+      bool isProfilingEnabled() { return synthContext_.profiler != NULL; }
+      ProfileNode getProfile() { return profiler_.report(); }
+      void resetProfile();
+      
+      // scratch stack - allocate the replacement before locking, swap it in with the mutex locked
+      unsigned int scratchCapacity() { return scratch_.capacity(); }
+      void swapScratch(ScratchStack_ & scratch) { scratch_.swap(scratch); }
+      
+      // sample rate of this engine - generators pick up changes at the start of their next block
+      void setSampleRate(TonicFloat rate) { synthContext_.sampleRate = rate; }
+      TonicFloat getSampleRate() { return synthContext_.sampleRate; }
 
     };
     
+    // Objects released while the mutex is held are freed later by collectGarbage(), not under the lock
     inline void BufferFiller_::lockMutex(){
       TONIC_MUTEX_LOCK(mutex_);
+      beginDeferredDestruction();
     }
     
     inline void BufferFiller_::unlockMutex(){
+      endDeferredDestruction();
       TONIC_MUTEX_UNLOCK(mutex_);
     }
     
@@ -70,6 +95,63 @@ namespace Tonic{
       unlockMutex();
     }
     
+    // -- Block conversion kernels --
+    
+    //! Average interleaved stereo frames down to mono
+    inline void mixStereoToMono( const TonicFloat *in, float *out, unsigned int nFrames ){
+      vmixstereo(in, out, nFrames);
+    }
+    
+    //! Split interleaved stereo frames into two planar channels
+    inline void deinterleaveStereo( const TonicFloat *in, float *left, float *right, unsigned int nFrames ){
+      vdeinterleave(in, left, right, nFrames);
+    }
+    
+    inline void BufferFiller_::readInterleaved(float *outData, unsigned int nFrames, unsigned int numChannels){
+      
+      const unsigned int nChannels = outputFrames_.channels();
+      const TonicFloat *inptr = &outputFrames_[bufferReadPosition_ * nChannels];
+      
+      if (numChannels == nChannels){
+        memcpy(outData, inptr, nFrames * nChannels * sizeof(TonicFloat));
+      }
+      else if (numChannels == 1 && nChannels == 2){
+        mixStereoToMono(inptr, outData, nFrames);
+      }
+      else{
+        // more output channels than we have - repeat the last one
+        for (unsigned int i=0; i<nFrames; i++){
+          for (unsigned int c=0; c<numChannels; c++){
+            *outData++ = inptr[c < nChannels ? c : nChannels - 1];
+          }
+          inptr += nChannels;
+        }
+      }
+    }
+    
+    inline void BufferFiller_::readPlanar(float **outData, unsigned int offset, unsigned int nFrames, unsigned int numChannels){
+      
+      const unsigned int nChannels = outputFrames_.channels();
+      const TonicFloat *inptr = &outputFrames_[bufferReadPosition_ * nChannels];
+      
+      if (nChannels == 2 && numChannels == 2){
+        deinterleaveStereo(inptr, outData[0] + offset, outData[1] + offset, nFrames);
+      }
+      else if (nChannels == 2 && numChannels == 1){
+        mixStereoToMono(inptr, outData[0] + offset, nFrames);
+      }
+      else{
+        for (unsigned int c=0; c<numChannels; c++){
+          const TonicFloat *chanptr = inptr + (c < nChannels ? c : nChannels - 1);
+          float *outptr = outData[c] + offset;
+          for (unsigned int i=0; i<nFrames; i++){
+            *outptr++ = *chanptr;
+            chanptr += nChannels;
+          }
+        }
+      }
+    }
+    
     inline void BufferFiller_::fillBufferOfFloats(float *outData,  unsigned int numFrames, unsigned int numChannels)
     {
       
@@ -80,30 +162,56 @@ namespace Tonic{
       if(numChannels > outputFrames_.channels()) error("Mismatch in channels sent to Synth::fillBufferOfFloats", true);
 #endif
       
-      const unsigned long sampleCount = outputFrames_.size();
-      const unsigned int channelsPerSample = (outputFrames_.channels() - numChannels) + 1;
+      // whole runs of frames are converted at once, a new block is computed whenever the last one is used up
+      const unsigned int blockFrames = outputFrames_.frames();
       
-      TonicFloat sample = 0.0f;
-      TonicFloat *outputSamples = &outputFrames_[bufferReadPosition_];
-      
-      for(unsigned int i = 0; i<numFrames * numChannels; i++){
+      while (numFrames > 0){
         
-        sample = 0;
+        if (bufferReadPosition_ == 0){
+          tick(outputFrames_);
+        }
         
-        for (unsigned int c = 0; c<channelsPerSample; c++){
-          if(bufferReadPosition_ == 0){
-            tick(outputFrames_);
-          }
-          
-          sample += *outputSamples++;
-          
-          if(++bufferReadPosition_ == sampleCount){
-            bufferReadPosition_ = 0;
-            outputSamples = &outputFrames_[0];
-          }
+        unsigned int nFrames = std::min(numFrames, blockFrames - bufferReadPosition_);
+        readInterleaved(outData, nFrames, numChannels);
+        
+        outData += nFrames * numChannels;
+        numFrames -= nFrames;
+        
+        bufferReadPosition_ += nFrames;
+        if (bufferReadPosition_ == blockFrames){
+          bufferReadPosition_ = 0;
         }
+      }
+    }
+    
+    inline void BufferFiller_::fillPlanarBufferOfFloats(float **outData, unsigned int numFrames, unsigned int numChannels)
+    {
+      
+      // flush denormals on this thread
+      TONIC_ENABLE_DENORMAL_ROUNDING();
+      
+#ifdef TONIC_DEBUG
+      if(numChannels > outputFrames_.channels()) error("Mismatch in channels sent to Synth::fillPlanarBufferOfFloats", true);
+#endif
+      
+      const unsigned int blockFrames = outputFrames_.frames();
+      unsigned int offset = 0;
+      
+      while (offset < numFrames){
         
-        *outData++ = sample / (float)channelsPerSample;
+        if (bufferReadPosition_ == 0){
+          tick(outputFrames_);
+        }
+        
+        unsigned int nFrames = std::min(numFrames - offset, blockFrames - bufferReadPosition_);
+        readPlanar(outData, offset, nFrames, numChannels);
+        
+        offset += nFrames;
+        
+        bufferReadPosition_ += nFrames;
+        if (bufferReadPosition_ == blockFrames){
+          bufferReadPosition_ = 0;
+        }
       }
     }
     
@@ -122,6 +230,76 @@ namespace Tonic{
     inline void fillBufferOfFloats(float *outData,  unsigned int numFrames, unsigned int numChannels){
       static_cast<Tonic_::BufferFiller_*>(obj)->fillBufferOfFloats(outData, numFrames, numChannels);
     }
+    
+    //! Fill non-interleaved buffers of audio samples as floats, one per channel (e.g. for JACK or VST hosts)
+    /*!
+     outData is an array of numChannels pointers, each to a buffer of at least numFrames floats.
+     Shares its position in the output stream with fillBufferOfFloats.
+     */
+    inline void fillPlanarBufferOfFloats(float **outData,  unsigned int numFrames, unsigned int numChannels){
+      static_cast<Tonic_::BufferFiller_*>(obj)->fillPlanarBufferOfFloats(outData, numFrames, numChannels);
+    }
+    
+    //! Set the sample rate this BufferFiller renders at. Defaults to Tonic::sampleRate() at creation.
+    /*!
+        Can be changed while running. Every generator in the graph recomputes its rate-dependent state
+        (filter coefficients, oscillator increments, delay lengths) before its next block, so patches
+        don't need to be rebuilt. Delay lines are cleared when the rate changes. Delay buffers are sized
+        for Tonic::maxSampleRate() when they are built, so rates up to that one switch without allocating;
+        a higher rate reallocates them on the audio thread. BufferFillers with different rates can run
+        side by side in the same process.
+     */
+    void setSampleRate(TonicFloat rate){
+      Tonic_::BufferFiller_ * bf = static_cast<Tonic_::BufferFiller_*>(obj);
+      bf->lockMutex();
+      bf->setSampleRate(rate);
+      bf->unlockMutex();
+    }
+    
+    TonicFloat getSampleRate(){
+      return static_cast<Tonic_::BufferFiller_*>(obj)->getSampleRate();
+    }
+    
+    //! Enable or disable per-node CPU profiling of the synthesis graph. Disabled by default.
+    /*!
+        While enabled, every generator computed by this BufferFiller records the time it spends
+        computing its output. Adds a small overhead per node per block, so leave it off unless diagnosing.
+        Measurements accumulate across enable/disable cycles until resetProfile() is called.
+        Storage for Profiler_::kDefaultCapacity nodes is reserved the first time profiling is enabled,
+        so measuring never allocates on the audio thread. Nodes past that are counted in their consumer.
+     */
+    void setProfilingEnabled(bool enabled){
+      Tonic_::BufferFiller_ * bf = static_cast<Tonic_::BufferFiller_*>(obj);
+      bf->lockMutex();
+      bf->setProfilingEnabled(enabled);
+      bf->unlockMutex();
+    }
+    
+    bool isProfilingEnabled(){
+      return static_cast<Tonic_::BufferFiller_*>(obj)->isProfilingEnabled();
+    }
+    
+    //! Hierarchical CPU cost of each node in the graph since profiling was enabled or last reset
+    ProfileNode getProfile(){
+      Tonic_::BufferFiller_ * bf = static_cast<Tonic_::BufferFiller_*>(obj);
+      bf->lockMutex();
+      ProfileNode profile = bf->getProfile();
+      bf->unlockMutex();
+      return profile;
+    }
+    
+    //! Same as getProfile(), formatted as an indented table
+    string getProfileReport(){
+      return getProfile().toString();
+    }
+    
+    //! Discard profiling measurements. Call after changing the graph so removed nodes don't linger in the report.
+    void resetProfile(){
+      Tonic_::BufferFiller_ * bf = static_cast<Tonic_::BufferFiller_*>(obj);
+      bf->lockMutex();
+      bf->resetProfile();
+      bf->unlockMutex();
+    }
   
   };
   
@@ -24,7 +24,7 @@ namespace Tonic { namespace Tonic_{
   void  BufferPlayer_::setBuffer(SampleTable buffer){
     buffer_ = buffer;
     setIsStereoOutput(buffer.channels() == 2);
-    samplesPerSynthesisBlock = kSynthesisBlockSize * buffer_.channels();
+    samplesPerSynthesisBlock = synthesisBlockSize() * buffer_.channels();
   }
   
   inline void BufferPlayer_::computeSynthesisBlock(const SynthesisContext_ &context){
@@ -35,12 +35,13 @@ namespace Tonic { namespace Tonic_{
     
     if(trigger){
       isFinished_ = false;
-      currentSample = startPosition * sampleRate() * buffer_.channels();
+      currentSample = startPosition * sampleRate_ * buffer_.channels();
     }
     
     if(isFinished_){
-      outputFrames_.clear();
+      setConstantOutput(0);
     }else{
+      isConstantOutput_ = false;
       int samplesLeftInBuf = (int)buffer_.size() - currentSample;
       int samplesToCopy = min(samplesPerSynthesisBlock, samplesLeftInBuf);
       copySamplesToOutputBuffer(currentSample, samplesToCopy);
@@ -46,6 +46,8 @@ namespace Tonic {
       void setTrigger(ControlGenerator trigger){trigger_ = trigger;}
       void setStartPosition(ControlGenerator startPosition){startPosition_ = startPosition;}
       
+      bool canBecomeSilent(){ return true; };
+      
     };
     
     inline void BufferPlayer_::copySamplesToOutputBuffer(int startSample, int numSamples){
@@ -57,7 +59,7 @@ namespace Tonic {
   
   /*!
     Simply plays back a buffer. "loop" parameter works, but doesn't wrap between ticks, so mostly likely you'll wind up with a few zeroes at the end of 
-    the last buffer if you're looping. In other words, buffer lenghts are rounded up to the nearest kSynthesisBlockSize 
+    the last buffer if you're looping. In other words, buffer lenghts are rounded up to the nearest synthesis block size 
    
     Usage:
     
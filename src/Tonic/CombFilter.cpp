@@ -12,14 +12,15 @@
 
 namespace Tonic { namespace Tonic_{
   
-  CombFilter_::CombFilter_(){
-    delayTimeFrames_.resize(kSynthesisBlockSize, 1, 0);
-  }
+  CombFilter_::CombFilter_(){}
   
   void CombFilter_::initialize(float initialDelayTime, float maxDelayTime){
     if (maxDelayTime < 0) maxDelayTime = initialDelayTime * 1.5;
     delayLine_.initialize(maxDelayTime, 1);
     delayTimeGen_ = FixedValue(initialDelayTime);
+    
+    // sleep only after a full pass through the delay line has decayed
+    setSilenceDetection(maxDelayTime, silenceThreshold_);
   }
   
   FilteredFBCombFilter6_::FilteredFBCombFilter6_() : lastOutLow_(0), lastOutHigh_(0)
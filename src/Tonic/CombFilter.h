@@ -28,15 +28,20 @@ namespace Tonic {
       Generator           delayTimeGen_;
       ControlGenerator    scaleFactorCtrlGen_;
       
-      TonicFrames         delayTimeFrames_;
+      void sampleRateChanged(){ delayLine_.setSampleRate(sampleRate_); };
       
     public:
       
       CombFilter_();
       
+      void appendInputs( vector<Generator_*> & inputs ){
+        Effect_::appendInputs(inputs);
+        inputs.push_back(delayTimeGen_.rawGenerator());
+      };
+
       void initialize(float initialDelayTime, float maxDelayTime);
       
-      void setDelayTimeGen(Generator gen){ delayTimeGen_ = gen; };
+      void setDelayTimeGen(Generator gen){ delayTimeGen_ = gen; inputsChanged(); };
       
       void setScaleFactorGen(ControlGenerator gen){ scaleFactorCtrlGen_ = gen; };
                   
@@ -50,15 +55,15 @@ namespace Tonic {
       inline void computeSynthesisBlock( const SynthesisContext_ &context ){
         
         // tick modulations
-        delayTimeGen_.tick(delayTimeFrames_, context);
+        ScratchFrames_ delayTimeFrames(context, 1);
+        const TonicFloat * dtptr = &delayTimeGen_.output(context, *delayTimeFrames)[0];
         
-        TonicFloat * inptr = &dryFrames_[0];
+        const TonicFloat * inptr = &dryInput()[0];
         TonicFloat * outptr = &outputFrames_[0];
-        TonicFloat * dtptr = &delayTimeFrames_[0];
         TonicFloat sf = scaleFactorCtrlGen_.tick(context).value;
         TonicFloat norm = (1.0f/(1.0f + sf));
         
-        for (unsigned int i=0; i<kSynthesisBlockSize; i++){
+        for (unsigned int i=0; i<synthesisBlockSize(); i++){
           delayLine_.tickIn(*inptr);
           *outptr++ = (*inptr++ + delayLine_.tickOut(*dtptr++) * sf) * norm;
           delayLine_.advance();
@@ -76,16 +81,16 @@ namespace Tonic {
       inline void computeSynthesisBlock( const SynthesisContext_ &context ){
         
         // tick modulations
-        delayTimeGen_.tick(delayTimeFrames_, context);
+        ScratchFrames_ delayTimeFrames(context, 1);
+        const TonicFloat * dtptr = &delayTimeGen_.output(context, *delayTimeFrames)[0];
         
         TonicFloat y = 0;
-        TonicFloat * inptr = &dryFrames_[0];
+        const TonicFloat * inptr = &dryInput()[0];
         TonicFloat * outptr = &outputFrames_[0];
-        TonicFloat * dtptr = &delayTimeFrames_[0];
         TonicFloat sf = scaleFactorCtrlGen_.tick(context).value;
         TonicFloat norm = (1.0f/(1.0f + sf));
         
-        for (unsigned int i=0; i<kSynthesisBlockSize; i++){
+        for (unsigned int i=0; i<synthesisBlockSize(); i++){
           y = ((delayLine_.tickOut(*dtptr++) * sf) + *inptr++) * norm;
           delayLine_.tickIn(y);
           *outptr++ = y;
@@ -127,19 +132,19 @@ namespace Tonic {
     inline void FilteredFBCombFilter6_::computeSynthesisBlock( const SynthesisContext_ &context ){
       
       // tick modulations
-      delayTimeGen_.tick(delayTimeFrames_, context);
+      ScratchFrames_ delayTimeFrames(context, 1);
+      const TonicFloat * dtptr = &delayTimeGen_.output(context, *delayTimeFrames)[0];
       
       TonicFloat y = 0;
-      TonicFloat * inptr = &dryFrames_[0];
+      const TonicFloat * inptr = &dryInput()[0];
       TonicFloat * outptr = &outputFrames_[0];
-      TonicFloat * dtptr = &delayTimeFrames_[0];
       
       TonicFloat sf = scaleFactorCtrlGen_.tick(context).value;
       
-      TonicFloat lowCoef = cutoffToOnePoleCoef(lowCutoffGen_.tick(context).value);
-      TonicFloat hiCoef = 1.0f - cutoffToOnePoleCoef(highCutoffGen_.tick(context).value);
+      TonicFloat lowCoef = cutoffToOnePoleCoef(lowCutoffGen_.tick(context).value, sampleRate_);
+      TonicFloat hiCoef = 1.0f - cutoffToOnePoleCoef(highCutoffGen_.tick(context).value, sampleRate_);
       
-      for (unsigned int i=0; i<kSynthesisBlockSize; i++){
+      for (unsigned int i=0; i<synthesisBlockSize(); i++){
         onePoleLPFTick(delayLine_.tickOut(*dtptr++), lastOutLow_, lowCoef);
         onePoleHPFTick(lastOutLow_, lastOutHigh_, hiCoef);
         y = ((lastOutHigh_ * sf) + *inptr++); // no normalization on purpose
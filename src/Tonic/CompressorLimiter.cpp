@@ -10,12 +10,45 @@
 
 namespace Tonic { namespace Tonic_{
   
-  Compressor_::Compressor_() : isLimiter_(false), gainEnvValue_(1.f), ampEnvValue_(0) {
-    ampInputFrames_.resize(kSynthesisBlockSize, 1, 0);
-    lookaheadDelayLine_.initialize(0.01, 2);
+  // length of the lookahead delay line, in seconds
+  static const TonicFloat kMaxLookaheadTime = 0.01f;
+  
+  Compressor_::Compressor_() :
+    isLimiter_(false),
+    gainEnvValue_(1.f),
+    ampEnvValue_(0),
+    windowPeak_(0),
+    lastLookaheadFrames_(0),
+    lastAttack_(-1),
+    lastRelease_(-1),
+    attackCoef_(0),
+    releaseCoef_(0)
+  {
+    ampInputFrames_.resize(synthesisBlockSize(), 1, 0);
+    lookaheadDelayLine_.initialize(kMaxLookaheadTime, 2);
     lookaheadDelayLine_.setInterpolates(false); // No real need to interpolate here for lookahead
+    
+    // window long enough for the whole delay line at the highest rate, so a rate change only clears it
+    lookaheadPeak_.initialize(lookaheadWindowLength(max(sampleRate_, Tonic::maxSampleRate())));
     makeupGainGen_ = ControlValue(1.f);
   }
+  
+  unsigned int Compressor_::lookaheadWindowLength( TonicFloat sampleRate ){
+    return (unsigned int)max(2, kMaxLookaheadTime * sampleRate) + 1;
+  }
+  
+  void Compressor_::sampleRateChanged(){
+    // neither reallocates unless the rate is above Tonic::maxSampleRate()
+    lookaheadDelayLine_.setSampleRate(sampleRate_);
+    if (lookaheadWindowLength(sampleRate_) > lookaheadPeak_.maxLength()){
+      lookaheadPeak_.initialize(lookaheadWindowLength(sampleRate_));
+    }
+    else{
+      lookaheadPeak_.clear();
+    }
+    lastAttack_ = -1;
+    lastRelease_ = -1;
+  }
 
   // Default inherited input method sets both audio signal and amplitude signal as input
   // so incoming signal is compressed based on its own amplitude
@@ -26,19 +59,21 @@ namespace Tonic { namespace Tonic_{
   
   void Compressor_::setAudioInput( Generator gen ) {
     input_ = gen;
+    inputsChanged();
     setIsStereoInput(gen.isStereoOutput());
     setIsStereoOutput(gen.isStereoOutput());
   }
   
   void Compressor_::setAmplitudeInput( Generator gen ) {
     amplitudeInput_ = gen;
-    ampInputFrames_.resize(kSynthesisBlockSize, amplitudeInput_.isStereoOutput() ? 2 : 1, 0);
+    inputsChanged();
+    ampInputFrames_.resize(synthesisBlockSize(), amplitudeInput_.isStereoOutput() ? 2 : 1, 0);
   }
   
   void Compressor_::setIsStereo(bool isStereo){
     setIsStereoInput(isStereo);
     setIsStereoOutput(isStereo);
-    ampInputFrames_.resize(kSynthesisBlockSize, isStereo ? 2 : 1, 0);
+    ampInputFrames_.resize(synthesisBlockSize(), isStereo ? 2 : 1, 0);
   }
   
 } // Namespace Tonic_
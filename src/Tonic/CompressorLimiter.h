@@ -36,23 +36,42 @@ namespace Tonic {
           
       DelayLine lookaheadDelayLine_;
       
+      // peak amplitude over the lookahead window
+      SlidingMaximum lookaheadPeak_;
+      
       TonicFrames ampInputFrames_;
 
       TonicFloat ampEnvValue_;
       TonicFloat gainEnvValue_;
       
+      // upper bound of the lookahead peak at the end of the last block, and the window length it was taken over
+      TonicFloat windowPeak_;
+      unsigned int lastLookaheadFrames_;
+      
+      // envelope coefficients for the last attack and release times
+      TonicFloat lastAttack_;
+      TonicFloat lastRelease_;
+      TonicFloat attackCoef_;
+      TonicFloat releaseCoef_;
+      
       bool isLimiter_;
       
       void computeSynthesisBlock( const SynthesisContext_ &context );
       
+      void sampleRateChanged();
+      
+      // lookahead window covering the whole lookahead delay line at sampleRate
+      static unsigned int lookaheadWindowLength( TonicFloat sampleRate );
+      
     public:
       
       Compressor_();
 
       // Base class methods overridden here for specialized input behavior
       void setInput( Generator input );
-      void tick(TonicFrames &frames, const SynthesisContext_ & context );
-      void tickThrough(TonicFrames & inFrames, TonicFrames & outFrames, const SynthesisContext_ & context);
+      void updateOutput( const SynthesisContext_ & context );
+      void appendInputs( vector<Generator_*> & inputs );
+      void tickThrough(const TonicFrames & inFrames, TonicFrames & outFrames, const SynthesisContext_ & context);
       
       // setters
       void setAudioInput( Generator gen );
@@ -73,114 +92,166 @@ namespace Tonic {
       
     };
     
-    inline void Compressor_::tick(TonicFrames &frames, const SynthesisContext_ &context ){
+    inline void Compressor_::updateOutput( const SynthesisContext_ &context ){
       
       if (context.forceNewOutput || lastFrameIndex_ != context.elapsedFrames){
         amplitudeInput_.tick(ampInputFrames_, context); // get amp input frames
       }
-      Effect_::tick(frames, context);
+      Effect_::updateOutput(context);
       
     }
     
-    inline void Compressor_::tickThrough(TonicFrames & inFrames, TonicFrames & outFrames, const SynthesisContext_ & context){
+    inline void Compressor_::appendInputs( vector<Generator_*> & inputs ){
+      Effect_::appendInputs(inputs);
+      inputs.push_back(amplitudeInput_.rawGenerator());
+    }
+    
+    inline void Compressor_::tickThrough(const TonicFrames & inFrames, TonicFrames & outFrames, const SynthesisContext_ & context){
       ampInputFrames_.copy(inFrames);
       Effect_::tickThrough(inFrames, outFrames, context);
     }
     
     inline void Compressor_::computeSynthesisBlock(const SynthesisContext_ &context){
       
-      // Tick all scalar parameters
-      float attackCoef = t60ToOnePoleCoef(max(0,attackGen_.tick(context).value));
-      float releaseCoef = t60ToOnePoleCoef(max(0, releaseGen_.tick(context).value));
+      // Tick all scalar parameters. The envelope coefficients only change with attack and release.
+      float attack = max(0, attackGen_.tick(context).value);
+      float release = max(0, releaseGen_.tick(context).value);
       float threshold = max(0,threshGen_.tick(context).value);
       float ratio = max(0,ratioGen_.tick(context).value);
       float lookaheadTime = max(0,lookaheadGen_.tick(context).value);
       
-      // Absolute value of amplitude frames in prep for amp envelope
+      if (attack != lastAttack_){
+        attackCoef_ = t60ToOnePoleCoef(attack, sampleRate_);
+        lastAttack_ = attack;
+      }
+      if (release != lastRelease_){
+        releaseCoef_ = t60ToOnePoleCoef(release, sampleRate_);
+        lastRelease_ = release;
+      }
+      const TonicFloat attackCoef = attackCoef_;
+      const TonicFloat releaseCoef = releaseCoef_;
+      
+      const unsigned int nFrames = synthesisBlockSize();
+      const unsigned int nChannels = outputFrames_.channels();
+      const unsigned int nAmpChannels = ampInputFrames_.channels();
+      
+      // Delay the input by the lookahead time
+      lookaheadDelayLine_.tick(&dryInput()[0], &outputFrames_[0], nFrames, nChannels, lookaheadTime);
+      
+      // Amplitude input: the peak of all channels for each frame. Overwrites the start of ampInputFrames_.
       TonicFloat * ampData = &ampInputFrames_[0];
+      vabs(ampData, 1, ampData, 1, (unsigned int)ampInputFrames_.size());
       
-      #ifdef USE_APPLE_ACCELERATE
-      vDSP_vabs(ampData, 1, ampData, 1, ampInputFrames_.size());
-      #else
-      for (unsigned int i=0; i<ampInputFrames_.size(); i++, ampData++){
-        *ampData = fabsf(*ampData);
+      if (nAmpChannels > 1){
+        for (unsigned int i=0; i<nFrames; i++){
+          TonicFloat framePeak = ampData[i*nAmpChannels];
+          for (unsigned int c=1; c<nAmpChannels; c++){
+            framePeak = max(framePeak, ampData[i*nAmpChannels + c]);
+          }
+          ampData[i] = framePeak;
+        }
       }
-      #endif
       
-      // Iterate through samples
-      unsigned int nChannels = outputFrames_.channels();
-      TonicFloat ampInputValue, gainValue, gainTarget;
-      TonicFloat * outptr = &outputFrames_[0];
-      TonicFloat * dryptr = &dryFrames_[0];
-      ampData = &ampInputFrames_[0];
+      // window over the samples still in the lookahead delay, which can't be longer than the delay line
+      const unsigned int lookaheadFrames = min((unsigned int)ceilf(lookaheadTime * sampleRate_),
+                                               (unsigned int)lookaheadDelayLine_.frames()) + 1;
       
-      for (unsigned int i=0; i<kSynthesisBlockSize; i++){
-        
-        // Tick input into lookahead delay and get amplitude input value - max of left/right
-        ampInputValue = 0;
-        for (unsigned int i=0; i<nChannels; i++){
-          lookaheadDelayLine_.tickIn(*dryptr++, i);
-          ampInputValue = max(ampInputValue,*ampData++);
+      // locals, so the compiler can keep them in registers rather than reloading them after every store
+      TonicFloat ampEnvValue = ampEnvValue_;
+      TonicFloat gainEnvValue = gainEnvValue_;
+      
+      // Cheap pre-scan of the block peak, only when the envelopes leave the fast path open
+      bool underThreshold = windowPeak_ <= threshold && lookaheadFrames == lastLookaheadFrames_ &&
+                            ampEnvValue <= threshold && fabsf(gainEnvValue - 1.f) < 1e-6f;
+      TonicFloat rawPeak = 0;
+      if (underThreshold){
+        for (unsigned int i=0; i<nFrames; i++){
+          rawPeak = max(rawPeak, ampData[i]);
         }
+        underThreshold = rawPeak <= threshold;
+      }
+      
+      // Fast path: the whole block and the lookahead window it carries over are under the threshold, and the
+      // gain envelope has settled at unity, so the gain is exactly 1. The samples only need to go into the
+      // window history, and the amplitude envelope is advanced to an upper bound of its exact value: a
+      // release towards the block peak. That can only make the gain come down sooner, never later.
+      if (underThreshold){
         
-        // Smooth amplitude input
-        if (ampInputValue >= ampEnvValue_){
-          onePoleLPFTick(ampInputValue, ampEnvValue_, attackCoef);
-        }
-        else {
-          onePoleLPFTick(ampInputValue, ampEnvValue_, releaseCoef);
-        }
+        gainEnvValue = 1.f;
         
-        // Calculate gain value
+        lookaheadPeak_.push(ampData, nFrames);
+        windowPeak_ = nFrames >= lookaheadFrames ? rawPeak : max(windowPeak_, rawPeak);
         
-        if (ampEnvValue_ <= threshold){
-          gainValue = 1.0f;
+        if (ampEnvValue > rawPeak){
+          ampEnvValue = rawPeak + (ampEnvValue - rawPeak) * powf(releaseCoef, (TonicFloat)nFrames);
         }
         else{
-          // compensate for ratio
-          gainTarget = threshold + ((ampEnvValue_ - threshold)/ratio);
-          gainValue = gainTarget/ampEnvValue_;
+          ampEnvValue = rawPeak;
         }
+      }
+      else{
         
-        // Smooth gain value
-        if (gainValue <= gainEnvValue_){
-          onePoleLPFTick(gainValue, gainEnvValue_, attackCoef);
-        }
-        else {
-          onePoleLPFTick(gainValue, gainEnvValue_, releaseCoef);
-        }
+        // The peak over the samples still in the lookahead delay, so the gain is already down when a peak comes out
+        lookaheadPeak_.tick(ampData, ampData, nFrames, lookaheadFrames);
         
-        // apply gain
-        for (unsigned int i=0; i<nChannels; i++){
-          *outptr++ = lookaheadDelayLine_.tickOut(lookaheadTime,i) * gainEnvValue_;
+        // Above the threshold the gain is (threshold + (env - threshold)/ratio)/env, or gainOffset/env + 1/ratio
+        const TonicFloat invRatio = 1.f/ratio;
+        const TonicFloat gainOffset = threshold * (1.f - invRatio);
+        
+        TonicFloat ampInputValue, gainValue;
+        TonicFloat * outptr = &outputFrames_[0];
+        
+        for (unsigned int i=0; i<nFrames; i++){
+          
+          ampInputValue = ampData[i];
+          
+          // Smooth amplitude input
+          if (ampInputValue >= ampEnvValue){
+            onePoleLPFTick(ampInputValue, ampEnvValue, attackCoef);
+          }
+          else {
+            onePoleLPFTick(ampInputValue, ampEnvValue, releaseCoef);
+          }
+          
+          // Calculate gain value
+          
+          if (ampEnvValue <= threshold){
+            gainValue = 1.0f;
+          }
+          else{
+            gainValue = gainOffset/ampEnvValue + invRatio;
+          }
+          
+          // Smooth gain value
+          if (gainValue <= gainEnvValue){
+            onePoleLPFTick(gainValue, gainEnvValue, attackCoef);
+          }
+          else {
+            onePoleLPFTick(gainValue, gainEnvValue, releaseCoef);
+          }
+          
+          // apply gain
+          for (unsigned int c=0; c<nChannels; c++){
+            *outptr++ *= gainEnvValue;
+          }
         }
         
-        lookaheadDelayLine_.advance();
+        windowPeak_ = ampData[nFrames-1];
+        lastLookaheadFrames_ = lookaheadFrames;
       }
       
+      ampEnvValue_ = ampEnvValue;
+      gainEnvValue_ = gainEnvValue;
+      
       TonicFloat makeupGain = max(0.f, makeupGainGen_.tick(context).value);
-      outptr = &outputFrames_[0];
+      TonicFloat * outptr = &outputFrames_[0];
       
-      #ifdef USE_APPLE_ACCELERATE
-      vDSP_vsmul(outptr, 1, &makeupGain, outptr, 1, outputFrames_.size());
-      #else
-      for (unsigned int i=0; i<outputFrames_.size(); i++){
-        *outptr++ *= makeupGain;
-      }
-      #endif
+      vsmul(outptr, 1, makeupGain, outptr, 1, (unsigned int)outputFrames_.size());
       
       if (isLimiter_){
         
         // clip to threshold in worst case (minor distortion introduced but much preferable to wrapping distortion)
-        #ifdef USE_APPLE_ACCELERATE
-        float negThresh = -threshold;
-        vDSP_vclip(&outputFrames_[0], 1, &negThresh, &threshold, &outputFrames_[0], 1, outputFrames_.size());
-        #else
-        outptr = &outputFrames_[0];
-        for (unsigned int i=0; i<outputFrames_.size(); i++, outptr++){
-          *outptr = clamp(*outptr, -threshold, threshold);
-        }
-        #endif
+        vclip(&outputFrames_[0], 1, -threshold, threshold, &outputFrames_[0], 1, (unsigned int)outputFrames_.size());
         
       }
       
@@ -14,13 +14,24 @@ namespace Tonic {
     ControlDelay_::ControlDelay_() :
       readHead_(0),
       writeHead_(0),
-      maxDelay_(0)
+      maxDelay_(0),
+      maxDelayTime_(0),
+      sampleRate_(Tonic::sampleRate())
     {
     }
 
     void ControlDelay_::initialize(float maxDelayTime){
-      maxDelay_ = max(maxDelayTime * sampleRate() / kSynthesisBlockSize, 1);
-      delayLine_.resize(maxDelay_);
+      maxDelayTime_ = maxDelayTime;
+      
+      // reserve room for the highest rate up front, so a rate change doesn't allocate
+      delayLine_.reserve(max(maxDelayTime_ * max(sampleRate_, Tonic::maxSampleRate()) / synthesisBlockSize(), 1));
+      allocate();
+    }
+    
+    void ControlDelay_::allocate(){
+      maxDelay_ = max(maxDelayTime_ * sampleRate_ / synthesisBlockSize(), 1);
+      delayLine_.assign(maxDelay_, ControlGeneratorOutput());
+      writeHead_ = 0;
       readHead_ = maxDelay_ - 1;
     }
 
@@ -25,12 +25,18 @@ namespace Tonic {
           
       long maxDelay_; // # synthesis blocks of delay
       
+      float maxDelayTime_;
+      TonicFloat sampleRate_;
+      
       std::vector<ControlGeneratorOutput> delayLine_;
       
       ControlGenerator delayTimeCtrlGen_;
       
       void computeOutput(const SynthesisContext_ & context);
       
+      // size delay line for maxDelayTime_ at sampleRate_ and clear it. Only allocates above Tonic::maxSampleRate().
+      void allocate();
+      
     public:
       
       ControlDelay_();
@@ -43,12 +49,19 @@ namespace Tonic {
     
     inline void ControlDelay_::computeOutput(const SynthesisContext_ & context){
       
+      // delay length in blocks depends on the sample rate
+      bool rateChanged = context.sampleRate != sampleRate_;
+      if (rateChanged){
+        sampleRate_ = context.sampleRate;
+        allocate();
+      }
+      
       delayLine_[writeHead_] = input_.tick(context);
       
       ControlGeneratorOutput delayTimeOutput = delayTimeCtrlGen_.tick(context);
-      if (delayTimeOutput.triggered){
+      if (delayTimeOutput.triggered || rateChanged){
         
-        unsigned delayBlocks = max(delayTimeOutput.value * sampleRate() / kSynthesisBlockSize, 1);
+        unsigned delayBlocks = max(delayTimeOutput.value * sampleRate_ / synthesisBlockSize(), 1);
         
 #ifdef TONIC_DEBUG
         if (delayBlocks >= maxDelay_){
@@ -17,7 +17,8 @@ namespace Tonic{
   namespace Tonic_{
     
     ControlGenerator_::ControlGenerator_() :
-      lastFrameIndex_(0)
+      lastFrameIndex_(0),
+      nodeId_(newNodeId())
     {
     }
 
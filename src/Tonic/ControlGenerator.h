@@ -12,6 +12,7 @@
 #define TONIC_CONTROLGENERATOR_H
 
 #include "TonicCore.h"
+#include "Profiler.h"
 
 namespace Tonic {
   
@@ -25,7 +26,7 @@ namespace Tonic {
 
   namespace Tonic_{
 
-    class ControlGenerator_{
+    class ControlGenerator_ : public RefCounted_ {
       
     public:
     
@@ -43,6 +44,9 @@ namespace Tonic {
       // Used for initializing other generators (see smoothed() method for example)
       virtual ControlGeneratorOutput initialOutput();
       
+      //! Unique for the life of the process, unlike the address. Identifies this node in profiles.
+      int nodeId() const { return nodeId_; }
+      
     protected:
       
       //! Override this function to implement a new ControlGenerator
@@ -54,11 +58,16 @@ namespace Tonic {
       ControlGeneratorOutput  output_;
       unsigned long           lastFrameIndex_;
       
+    private:
+      
+      int                     nodeId_;
+      
     };
     
     inline ControlGeneratorOutput ControlGenerator_::tick(const SynthesisContext_ & context){
       
       if (context.forceNewOutput || lastFrameIndex_ != context.elapsedFrames){
+        ProfilerScope_ profile(context.profiler, nodeId(), typeid(*this));
         lastFrameIndex_ = context.elapsedFrames;
         computeOutput(context);
       }
@@ -117,7 +126,7 @@ return methodNameInGenerator( ControlValue(arg) );
 }                                                                                  \
 \
 generatorClassName& methodNameInGenerator(ControlGenerator arg){                   \
-this->gen()->methodNameInGenerator_(arg);                                          \
+this->gen()->methodNameInGenerator_(TONIC_MOVE(arg));                              \
 return static_cast<generatorClassName&>(*this);                                    \
 }
 
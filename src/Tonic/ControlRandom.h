@@ -13,6 +13,7 @@
 
 #include <iostream>
 #include "ControlConditioner.h"
+#include "Random.h"
 
 namespace Tonic{
 
@@ -20,6 +21,7 @@ namespace Tonic_{
 
   class ControlRandom_ : public ControlGenerator_{
    
+    Random random_;
    
     void computeOutput(const SynthesisContext_ & context);
     public:
@@ -33,6 +35,7 @@ namespace Tonic_{
     void setMax(ControlGenerator maxArg){max = maxArg;};
     void setMin(ControlGenerator minArg){min = minArg;};
     void setTrigger(ControlGenerator arg){trigger = arg;}
+    void setSeed(TonicUInt32 seed){random_.seed(seed);}
   };
   
   inline void ControlRandom_::computeOutput(const SynthesisContext_ & context){
@@ -43,7 +46,7 @@ namespace Tonic_{
     
     if(!outInRange || trigger.tick(context).triggered){
       output_.triggered = true;
-      output_.value = randomFloat(minOut.value, maxOut.value);
+      output_.value = random_.nextFloat(minOut.value, maxOut.value);
     }else{
       output_.triggered = false;
     }
@@ -60,6 +63,12 @@ namespace Tonic_{
     TONIC_MAKE_CTRL_GEN_SETTERS(ControlRandom, max, setMax)
     TONIC_MAKE_CTRL_GEN_SETTERS(ControlRandom, min, setMin)
     TONIC_MAKE_CTRL_GEN_SETTERS(ControlRandom, trigger, setTrigger)
+    
+    //! Restart the random sequence from a seed
+    ControlRandom & seed(TonicUInt32 seed){
+      gen()->setSeed(seed);
+      return *this;
+    }
   };
 
 }
@@ -0,0 +1,42 @@
+//
+//  DbToLinear.h
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#ifndef TONIC_DBTOLINEAR_H
+#define TONIC_DBTOLINEAR_H
+
+#include "Effect.h"
+
+namespace Tonic {
+
+  namespace Tonic_ {
+
+    class DbToLinear_ : public Effect_{
+
+    protected:
+
+      void computeSynthesisBlock( const SynthesisContext_ &context ){
+        vdbtolin(&dryInput()[0], &outputFrames_[0], outputFrames_.size());
+      }
+
+    public:
+
+      // a silent input is 0 dB, full scale
+      DbToLinear_(){ setSilenceDetection(-1, 0); }
+
+    };
+
+  }
+
+  //! Audio-rate counterpart of ControlDbToLinear: converts every sample of its input from dBFS to linear gain.
+  /*!
+      Uses the vectorized vdbtolin, so gain curves can be shaped per sample in decibels.
+   */
+  class DbToLinear : public TemplatedEffect<DbToLinear, Tonic_::DbToLinear_> {};
+
+}
+
+#endif
@@ -15,18 +15,40 @@ namespace Tonic {
     readHead_(0),
     writeHead_(0),
     isInitialized_(false),
-    interpolates_(true)
+    interpolates_(true),
+    maxDelay_(0),
+    sampleRate_(Tonic::sampleRate())
   {
-    resize(kSynthesisBlockSize, 1, 0);
+    resize(synthesisBlockSize(), 1, 0);
   }
   
   void DelayLine::initialize(float maxDelay, unsigned int channels)
   {
-    unsigned int nFrames = max(2, maxDelay * Tonic::sampleRate());
+    maxDelay_ = maxDelay;
+    
+    // reserve room for the same delay at the highest rate up front, so setSampleRate doesn't allocate
+    resize(max(2, maxDelay * max(sampleRate_, Tonic::maxSampleRate())), channels);
+    
+    unsigned int nFrames = max(2, maxDelay * sampleRate_);
     resize(nFrames, channels, 0);
     isInitialized_ = true;
   }
   
+  void DelayLine::setSampleRate(float sampleRate)
+  {
+    if (sampleRate == sampleRate_) return;
+    
+    sampleRate_ = sampleRate;
+    
+    if (isInitialized_){
+      initialize(maxDelay_, nChannels_);
+      clear();
+      writeHead_ = 0;
+      readHead_ = 0;
+      lastDelayTime_ = -1; // force read head to be recomputed
+    }
+  }
+  
   void DelayLine::clear()
   {
     if (isInitialized_){
@@ -34,4 +56,57 @@ namespace Tonic {
     }
   }
   
+  SlidingMaximum::SlidingMaximum() :
+    mask_(0),
+    maxLength_(0),
+    length_(0),
+    writeIndex_(0),
+    position_(0),
+    prefix_(0)
+  {}
+  
+  void SlidingMaximum::initialize( unsigned int maxLength )
+  {
+    maxLength_ = maxLength > 0 ? maxLength : 1;
+    
+    unsigned int capacity = 1;
+    while (capacity < maxLength_){
+      capacity <<= 1;
+    }
+    mask_ = capacity - 1;
+    
+    history_.assign(capacity, 0);
+    suffix_.assign(maxLength_ + 1, 0);
+    writeIndex_ = 0;
+    length_ = 0; // start a segment on the next tick
+  }
+  
+  void SlidingMaximum::clear()
+  {
+    std::fill(history_.begin(), history_.end(), 0);
+    writeIndex_ = 0;
+    length_ = 0; // start a segment on the next tick
+  }
+  
+  void SlidingMaximum::startSegment()
+  {
+    const TonicFloat lowest = -numeric_limits<TonicFloat>::max();
+    
+    // suffix maxima of the last length_ samples pushed, oldest first
+    const TonicFloat * history = &history_[0];
+    TonicFloat * suffix = &suffix_[0];
+    TonicFloat suffixMax = lowest;
+    unsigned int readIndex = writeIndex_;
+    
+    suffix[length_] = lowest;
+    for (unsigned int i=length_; i>0; i--){
+      readIndex = (readIndex - 1) & mask_;
+      suffixMax = max(suffixMax, history[readIndex]);
+      suffix[i-1] = suffixMax;
+    }
+    
+    position_ = 0;
+    prefix_ = lowest;
+  }
+  
 }
\ No newline at end of file
@@ -27,6 +27,20 @@ namespace Tonic {
     float readHead_;
     float lastDelayTime_;
     
+    float maxDelay_;
+    float sampleRate_;
+    
+    inline void updateReadHead(float delayTime){
+      if (delayTime != lastDelayTime_){
+        float dSamp = clamp(delayTime * sampleRate_, 0, nFrames_);
+        readHead_ = (float)writeHead_ - dSamp;
+        if (readHead_ < 0) {
+          readHead_ += (float)nFrames_;
+        }
+        lastDelayTime_ = delayTime;
+      }
+    }
+    
   public:
     
     //! Allocation parameters are binding. No post-allocation resizing or modifying channel layout (for now anyway).
@@ -38,6 +52,14 @@ namespace Tonic {
     //! MUST be called prior to usage
     void initialize(float maxDelay = 1.0f, unsigned int channels = 1);
     
+    //! Sample rate delay times are measured in. Defaults to Tonic::sampleRate().
+    /*!
+        If the rate changes after initialization, the line is resized for the same maximum delay time
+        at the new rate and cleared. Storage is reserved for Tonic::maxSampleRate() at initialization,
+        so this only allocates above that rate. Owners should call this when their sample rate changes.
+    */
+    void setSampleRate( float sampleRate );
+    
     //! Set whether interpolates or not
     void setInterpolates( bool doesInterpolate ) { interpolates_ = doesInterpolate; };
     
@@ -56,14 +78,7 @@ namespace Tonic {
     
     inline TonicFloat tickOut(float delayTime, unsigned int channel = 0) {
       
-      if (delayTime != lastDelayTime_){
-        float dSamp = clamp(delayTime * Tonic::sampleRate(), 0, nFrames_);
-        readHead_ = (float)writeHead_ - dSamp;
-        if (readHead_ < 0) {
-          readHead_ += (float)nFrames_;
-        }
-        lastDelayTime_ = delayTime;
-      }
+      updateReadHead(delayTime);
       
       if (interpolates_){
         // Fractional and integral part of read head
@@ -105,9 +120,160 @@ namespace Tonic {
       }
 
     }
+    
+    //! Tick a block of interleaved frames in and read them out delayed by delayTime, advancing the heads.
+    /*!
+        Same as tickIn, tickOut and advance for every frame, with delayTime held for the whole block.
+        input and output have nChannels channels, which may be fewer than the line has, and may be the same buffer.
+    */
+    inline void tick(const TonicFloat * input, TonicFloat * output, unsigned int nFrames, unsigned int nChannels, float delayTime){
+      
+      if (interpolates_){
+        for (unsigned int i=0; i<nFrames; i++){
+          for (unsigned int c=0; c<nChannels; c++){
+            tickIn(*input++, c);
+            *output++ = tickOut(delayTime, c);
+          }
+          advance();
+        }
+        return;
+      }
+      
+      // Without interpolation both heads move a whole frame at a time, so index with integers
+      updateReadHead(delayTime);
+      
+      const unsigned long nSamples = size_;
+      const unsigned int stride = nChannels_;
+      unsigned long writeIndex = writeHead_ * stride;
+      unsigned long readIndex = ((unsigned long)readHead_) * stride;
+      
+      for (unsigned int i=0; i<nFrames; i++){
+        for (unsigned int c=0; c<nChannels; c++){
+          data_[writeIndex + c] = input[c];
+          output[c] = data_[readIndex + c];
+        }
+        input += nChannels;
+        output += nChannels;
+        if ((writeIndex += stride) >= nSamples) writeIndex = 0;
+        if ((readIndex += stride) >= nSamples) readIndex = 0;
+      }
+      
+      writeHead_ = writeIndex / stride;
+      readHead_ += (float)(nFrames % nFrames_);
+      if (readHead_ >= nFrames_){
+        readHead_ -= (float)nFrames_;
+      }
+    }
                      
   };
   
+  //! Running maximum over a sliding window of samples, in O(1) time per sample whatever the window length.
+  /*!
+      Uses the van Herk/Gil-Werman method: time is split into segments as long as the window, so every
+      window spans the end of the previous segment and the start of the current one. The maximum is the
+      larger of a running maximum since the current segment started and the suffix maximum of the
+      previous segment, computed once when that segment ended. There are no data-dependent branches.
+  */
+  class SlidingMaximum {
+    
+  private:
+    
+    // the last samples pushed, power-of-two sized
+    vector<TonicFloat> history_;
+    
+    // suffix maxima of the previous segment, plus an empty-suffix entry at the end
+    vector<TonicFloat> suffix_;
+    
+    unsigned int mask_;
+    unsigned int maxLength_;
+    unsigned int length_;
+    unsigned int writeIndex_;
+    unsigned int position_;
+    TonicFloat   prefix_;
+    
+    // end the current segment at the last sample pushed and start a new one
+    void startSegment();
+    
+  public:
+    
+    SlidingMaximum();
+    
+    //! MUST be called prior to usage. Clears the window.
+    void initialize( unsigned int maxLength );
+    
+    //! Clear the window without reallocating
+    void clear();
+    
+    unsigned int maxLength() const { return maxLength_; }
+    
+    //! Push nFrames samples from input without computing any maxima.
+    /*!
+        For blocks whose maxima are known not to matter. The next tick starts a new segment.
+    */
+    inline void push( const TonicFloat * input, unsigned int nFrames ){
+      
+      const unsigned int capacity = mask_ + 1;
+      if (nFrames > capacity){
+        input += nFrames - capacity;
+        nFrames = capacity;
+      }
+      
+      const unsigned int firstRun = min(nFrames, capacity - writeIndex_);
+      memcpy(&history_[writeIndex_], input, firstRun * sizeof(TonicFloat));
+      memcpy(&history_[0], input + firstRun, (nFrames - firstRun) * sizeof(TonicFloat));
+      writeIndex_ = (writeIndex_ + nFrames) & mask_;
+      length_ = 0;
+    }
+    
+    //! Push nFrames samples from input and write the maximum of the window ending at each one to output.
+    /*!
+        The window is the last length samples pushed, including the current one, and is clamped to
+        [1, maxLength]. Samples pushed before the last call to initialize count as 0.
+        input and output may be the same buffer.
+    */
+    inline void tick( const TonicFloat * input, TonicFloat * output, unsigned int nFrames, unsigned int length ){
+      
+      length = length < 1 ? 1 : (length > maxLength_ ? maxLength_ : length);
+      
+      if (length != length_){
+        length_ = length;
+        startSegment();
+      }
+      
+      // locals, so the compiler can keep them in registers rather than reloading them after every store
+      TonicFloat * history = &history_[0];
+      const unsigned int mask = mask_;
+      unsigned int writeIndex = writeIndex_;
+      
+      unsigned int i = 0;
+      while (i < nFrames){
+        
+        // run up to the end of the block or of the current segment, whichever comes first
+        const unsigned int runLength = min(nFrames - i, length_ - position_);
+        const TonicFloat * suffix = &suffix_[position_ + 1];
+        TonicFloat prefix = prefix_;
+        
+        for (unsigned int j=0; j<runLength; j++){
+          const TonicFloat value = input[i + j];
+          history[writeIndex] = value;
+          writeIndex = (writeIndex + 1) & mask;
+          prefix = max(prefix, value);
+          output[i + j] = max(prefix, suffix[j]);
+        }
+        
+        i += runLength;
+        position_ += runLength;
+        prefix_ = prefix;
+        writeIndex_ = writeIndex;
+        
+        if (position_ == length_){
+          startSegment();
+        }
+      }
+    }
+    
+  };
+  
 }
 
 #endif
@@ -17,15 +17,18 @@ namespace Tonic
   namespace Tonic_
   {
    
-    Effect_::Effect_() : isStereoInput_(false)
+    Effect_::Effect_() :
+      isStereoInput_(false),
+      silenceTailTime_(0.1f),
+      silenceThreshold_(1e-5f),
+      quietFrames_(0)
     {
-      dryFrames_.resize(kSynthesisBlockSize, 1, 0);
+      dryInput_ = NULL;
       bypassGen_ = ControlValue(0);
     }
     
     WetDryEffect_::WetDryEffect_()
     {
-      mixWorkspace_.resize(kSynthesisBlockSize, 1, 0);
       dryLevelGen_ = FixedValue(0.5);
       wetLevelGen_ = FixedValue(0.5);
     }
@@ -23,92 +23,173 @@ namespace Tonic {
       protected:
         
         Generator input_;
-        TonicFrames dryFrames_;
+        
+        // Dry input for the current block. Usually points straight at the input's output block,
+        // only when the input's channel layout differs from this effect's is it converted into scratch frames.
+        const TonicFrames * dryInput_;
         
         ControlGenerator bypassGen_;
         bool isStereoInput_;
         
+        // Silence detection. Once the input has been silent and the output below silenceThreshold_
+        // for silenceTailTime_ seconds, the effect stops computing and outputs silence until the input returns.
+        TonicFloat    silenceTailTime_;   // negative disables sleeping
+        TonicFloat    silenceThreshold_;
+        unsigned long quietFrames_;
+        
+        // true if the block can be skipped. Marks the output silent. Call after the input is ticked.
+        bool sleepIfSilent();
+        
+        // track how long input has been silent and output quiet. Call after computing a block.
+        void updateSilence();
+        
       public:
         
         Effect_();
               
         void setBypassCtrlGen( ControlGenerator gen ){ bypassGen_ = gen; };
+        
+        //! Configure sleeping. tailTime should cover the longest delay in the effect, negative disables.
+        void setSilenceDetection( TonicFloat tailTime, TonicFloat threshold ){
+          silenceTailTime_ = tailTime;
+          silenceThreshold_ = threshold;
+          quietFrames_ = 0;
+        }
+        
+        bool canBecomeSilent(){ return silenceTailTime_ >= 0 && input_.rawGenerator()->canBecomeSilent(); };
 
-        virtual void setInput( Generator input ) { input_ = input; };
+        virtual void setInput( Generator input ) { input_ = input; inputsChanged(); };
         
-        //! set stereo/mono - changes number of channels in dryFrames_
+        //! set stereo/mono - changes number of channels in dryInput()
         /*!
             subclasses should call in constructor to determine input channel layout
         */
         virtual void setIsStereoInput( bool stereo );
         
         bool isStereoInput() { return isStereoInput_; };
+        
+        //! Dry input for the block being computed, stereo if isStereoInput(). Read-only.
+        /*!
+            Only valid inside computeSynthesisBlock().
+         */
+        const TonicFrames & dryInput() const { return *dryInput_; };
 
         // --- Tick methods ---
         
-        virtual void tick(TonicFrames &frames, const SynthesisContext_ &context );
+        virtual void updateOutput( const SynthesisContext_ &context );
+        virtual void appendInputs( vector<Generator_*> & inputs );
         
         //! Apply effect directly to passed in frames (output in-place)
         /*!
             DO NOT mix calls to tick() with calls to tickThrough().
         */
-        virtual void tickThrough( TonicFrames & inFrames, TonicFrames & outFrames, const SynthesisContext_ & context );
+        virtual void tickThrough( const TonicFrames & inFrames, TonicFrames & outFrames, const SynthesisContext_ & context );
 
     };
     
     
     inline void Effect_::setIsStereoInput(bool stereo)
     {
-      if (stereo != isStereoInput_){
-        dryFrames_.resize(kSynthesisBlockSize, stereo ? 2 : 1, 0);
-      }
       isStereoInput_ = stereo;
     }
     
-    // Overridden tick - pre-ticks input to fill dryFrames_.
-    // subclasses don't need to tick input - dryFrames_ contains "dry" input by the time
+    // Overridden updateOutput - pre-ticks input and points dryInput() at it.
+    // subclasses don't need to tick input - dryInput() contains "dry" input by the time
     // computeSynthesisBlock() is called
-    inline void Effect_::tick(TonicFrames &frames, const SynthesisContext_ &context ){
+    inline void Effect_::updateOutput( const SynthesisContext_ &context ){
       
       // check context to see if we need new frames
       if (context.elapsedFrames == 0 || lastFrameIndex_ != context.elapsedFrames){
         
+        ProfilerScope_ profile(context.profiler, nodeId(), typeid(*this));
+        
         // get dry input frames
-        input_.tick(dryFrames_, context);
+        ScratchFrames_ dryFrames(context, isStereoInput_ ? 2 : 1);
+        dryInput_ = &input_.output(context, *dryFrames);
+        
+        lastFrameIndex_ = context.elapsedFrames;
         
+        if (sleepIfSilent()) return;
+        
+        syncSampleRate(context);
         computeSynthesisBlock(context);
 
         // bypass processing - still need to compute block so all generators stay in sync
         bool bypass = bypassGen_.tick(context).value != 0.f;
         if (bypass){
-          outputFrames_.copy(dryFrames_);
+          outputFrames_.copy(*dryInput_);
         }
         
-        lastFrameIndex_ = context.elapsedFrames;
+        updateSilence();
       }
       
-      // copy synthesis block to frames passed in
-      frames.copy(outputFrames_);
-      
 #ifdef TONIC_DEBUG
-      if(!isfinite(frames(0,0))){
+      if(!isfinite(outputFrames_(0,0))){
         Tonic::error("Effect_::tick NaN or inf detected.");
       }
 #endif
       
     }
     
-    inline void Effect_::tickThrough(TonicFrames & inFrames, TonicFrames & outFrames, const SynthesisContext_ & context){
+    inline bool Effect_::sleepIfSilent(){
+      
+      if (silenceTailTime_ < 0 || !input_.isSilentOutput()) return false;
+      
+      if (quietFrames_ < (unsigned long)(silenceTailTime_ * sampleRate_)) return false;
+      
+      setConstantOutput(0);
+      return true;
+    }
+    
+    inline void Effect_::updateSilence(){
+      
+      isConstantOutput_ = false;
+      
+      if (silenceTailTime_ < 0) return;
+      
+      if (!input_.isSilentOutput()){
+        quietFrames_ = 0;
+        return;
+      }
+      
+      // only scan the output while the input is silent
+      const TonicFloat *outptr = &outputFrames_[0];
+      for (unsigned int i=0; i<outputFrames_.size(); i++){
+        if (fabsf(outptr[i]) > silenceThreshold_){
+          quietFrames_ = 0;
+          return;
+        }
+      }
+      quietFrames_ += outputFrames_.frames();
+    }
+    
+    inline void Effect_::appendInputs( vector<Generator_*> & inputs ){
+      inputs.push_back(input_.rawGenerator());
+    }
+    
+    inline void Effect_::tickThrough(const TonicFrames & inFrames, TonicFrames & outFrames, const SynthesisContext_ & context){
 
         // Do not check context here, assume each call should produce new output.
         
-        dryFrames_.copy(inFrames);
+        ProfilerScope_ profile(context.profiler, nodeId(), typeid(*this));
+        
+        ScratchFrames_ dryFrames(context, isStereoInput_ ? 2 : 1);
+        if (inFrames.channels() == dryFrames->channels()){
+          dryInput_ = &inFrames;
+        }
+        else{
+          dryFrames->copy(inFrames);
+          dryInput_ = &*dryFrames;
+        }
+        
+        syncSampleRate(context);
         computeSynthesisBlock(context);
         
         // bypass processing - still need to compute block so all generators stay in sync
         bool bypass = bypassGen_.tick(context).value != 0.f;
         if (bypass){
-          outFrames.copy(dryFrames_);
+          // in-place tick with bypass is already done
+          if (dryInput_ != &outFrames) outFrames.copy(*dryInput_);
         }
         else{
           outFrames.copy(outputFrames_);
@@ -133,7 +214,7 @@ namespace Tonic {
         this->gen()->tickThrough(inFrames, inFrames, context);
       }
       
-      void tickThrough(TonicFrames & inFrames, TonicFrames & outFrames, const Tonic_::SynthesisContext_ & context){
+      void tickThrough(const TonicFrames & inFrames, TonicFrames & outFrames, const Tonic_::SynthesisContext_ & context){
         this->gen()->tickThrough(inFrames, outFrames, context);
       }
       
@@ -142,6 +223,18 @@ namespace Tonic {
       }
       
       TONIC_MAKE_CTRL_GEN_SETTERS(EffectType, bypass, setBypassCtrlGen);
+      
+      //! Stop computing while the input is silent and the effect's tail has decayed.
+      /*!
+          Once the input has been silent, and the output below threshold (linear amplitude), for tailTime
+          seconds, the effect outputs silence without computing until its input is audible again.
+          tailTime should be at least the longest delay in the effect. Delays and reverbs choose a
+          suitable default. Pass a negative tailTime to always compute.
+       */
+      EffectType & silenceDetection( float tailTime, float threshold = 1e-5f ){
+        this->gen()->setSilenceDetection(tailTime, threshold);
+        return static_cast<EffectType&>(*this);
+      }
 
   };
   
@@ -166,87 +259,130 @@ namespace Tonic {
       
         Generator  dryLevelGen_;
         Generator  wetLevelGen_;
-        TonicFrames mixWorkspace_;
+      
+        // apply wet level to outputFrames_ and add the dry input at dry level
+        void mixWetDry( const SynthesisContext_ & context );
       
       public:
       
         WetDryEffect_();
       
-        void setDryLevelGen( Generator gen ){ dryLevelGen_ = gen; };
-        void setWetLevelGen( Generator gen ){ wetLevelGen_ = gen; };
+        void setDryLevelGen( Generator gen ){ dryLevelGen_ = gen; inputsChanged(); };
+        void setWetLevelGen( Generator gen ){ wetLevelGen_ = gen; inputsChanged(); };
       
       // --- Tick methods ---
       
-      virtual void tick(TonicFrames &frames, const SynthesisContext_ &context );
+      virtual void updateOutput( const SynthesisContext_ &context );
+      virtual void appendInputs( vector<Generator_*> & inputs );
       
       //! Apply effect directly to passed in frames (output in-place)
       /*!
           DO NOT mix calls to tick() with calls to tickThrough().
        */
-      virtual void tickThrough( TonicFrames & inFrames, TonicFrames & outFrames, const SynthesisContext_ & context );
+      virtual void tickThrough( const TonicFrames & inFrames, TonicFrames & outFrames, const SynthesisContext_ & context );
 
     };
     
-    // Overridden tick - pre-ticks input to fill dryFrames_.
-    // subclasses don't need to tick input - dryFrames_ contains "dry" input by the time
+    // Overridden updateOutput - pre-ticks input and points dryInput() at it.
+    // subclasses don't need to tick input - dryInput() contains "dry" input by the time
     // computeSynthesisBlock() is called
-    inline void WetDryEffect_::tick(TonicFrames &frames, const SynthesisContext_ &context ){
+    inline void WetDryEffect_::updateOutput( const SynthesisContext_ &context ){
       
       // check context to see if we need new frames
       if (context.elapsedFrames == 0 || lastFrameIndex_ != context.elapsedFrames){
         
+        ProfilerScope_ profile(context.profiler, nodeId(), typeid(*this));
+        
         // get dry input frames
-        input_.tick(dryFrames_, context);
+        ScratchFrames_ dryFrames(context, isStereoInput_ ? 2 : 1);
+        dryInput_ = &input_.output(context, *dryFrames);
+        
+        lastFrameIndex_ = context.elapsedFrames;
+        
+        if (sleepIfSilent()) return;
         
+        syncSampleRate(context);
         computeSynthesisBlock(context);
         
         // bypass processing - still need to compute block so all generators stay in sync
         bool bypass = bypassGen_.tick(context).value != 0.f;
         if (bypass){
-          outputFrames_.copy(dryFrames_);
+          outputFrames_.copy(*dryInput_);
         }
         else{
-          // do not apply dry/wet levels if always wet flag is set
-          // offers minor CPU usage optimization
-          wetLevelGen_.tick(mixWorkspace_, context);
-          outputFrames_ *= mixWorkspace_;
-          dryLevelGen_.tick(mixWorkspace_, context);
-          dryFrames_ *= mixWorkspace_;
-          outputFrames_ += dryFrames_;
+          mixWetDry(context);
         }
         
-        lastFrameIndex_ = context.elapsedFrames;
+        updateSilence();
       }
       
-      // copy synthesis block to frames passed in
-      frames.copy(outputFrames_);
-      
 #ifdef TONIC_DEBUG
-      if(!isfinite(frames(0,0))){
+      if(!isfinite(outputFrames_(0,0))){
         Tonic::error("Effect_::tick NaN or inf detected.");
       }
 #endif
       
     }
     
-    inline void WetDryEffect_::tickThrough(TonicFrames & inFrames, TonicFrames & outFrames, const SynthesisContext_ & context){
+    inline void WetDryEffect_::appendInputs( vector<Generator_*> & inputs ){
+      Effect_::appendInputs(inputs);
+      inputs.push_back(dryLevelGen_.rawGenerator());
+      inputs.push_back(wetLevelGen_.rawGenerator());
+    }
+    
+    inline void WetDryEffect_::mixWetDry( const SynthesisContext_ & context ){
+      
+      ScratchFrames_ workspace(context, 1);
+      
+      outputFrames_ *= wetLevelGen_.output(context, *workspace);
+      
+      // dry input is read-only, so scale it on the way into the output rather than in place
+      const TonicFrames & dryLevel = dryLevelGen_.output(context, *workspace);
+      const TonicFrames & dry = *dryInput_;
+      
+      const unsigned int nChannels = outputFrames_.channels();
+      const unsigned int dryChannels = dry.channels();
+      
+      TonicFloat *outptr = &outputFrames_[0];
+      const TonicFloat *dryptr = &dry[0];
+      const TonicFloat *levelptr = &dryLevel[0];
+      
+      for (unsigned int i=0; i<synthesisBlockSize(); i++){
+        for (unsigned int c=0; c<nChannels; c++){
+          outptr[c] += dryptr[c < dryChannels ? c : 0] * (*levelptr);
+        }
+        outptr += nChannels;
+        dryptr += dryChannels;
+        levelptr++;
+      }
+    }
+    
+    inline void WetDryEffect_::tickThrough(const TonicFrames & inFrames, TonicFrames & outFrames, const SynthesisContext_ & context){
       
       // Do not check context here, assume each call should produce new output.
       
-      dryFrames_.copy(inFrames);
+      ProfilerScope_ profile(context.profiler, nodeId(), typeid(*this));
+      
+      ScratchFrames_ dryFrames(context, isStereoInput_ ? 2 : 1);
+      if (inFrames.channels() == dryFrames->channels()){
+        dryInput_ = &inFrames;
+      }
+      else{
+        dryFrames->copy(inFrames);
+        dryInput_ = &*dryFrames;
+      }
+      
+      syncSampleRate(context);
       computeSynthesisBlock(context);
       
       // bypass processing - still need to compute block so all generators stay in sync
       bool bypass = bypassGen_.tick(context).value != 0.f;
       if (bypass){
-        outFrames.copy(dryFrames_);
+        // in-place tick with bypass is already done
+        if (dryInput_ != &outFrames) outFrames.copy(*dryInput_);
       }
       else {
-        wetLevelGen_.tick(mixWorkspace_, context);
-        outputFrames_ *= mixWorkspace_;
-        dryLevelGen_.tick(mixWorkspace_, context);
-        dryFrames_ *= mixWorkspace_;
-        outputFrames_ += dryFrames_;
+        mixWetDry(context);
         outFrames.copy(outputFrames_);
       }
             
@@ -269,7 +405,7 @@ namespace Tonic {
         this->gen()->tickThrough(inFrames, inFrames, context);
       }
       
-      void tickThrough(TonicFrames & inFrames, TonicFrames & outFrames, const Tonic_::SynthesisContext_ & context){
+      void tickThrough(const TonicFrames & inFrames, TonicFrames & outFrames, const Tonic_::SynthesisContext_ & context){
         this->gen()->tickThrough(inFrames, outFrames, context);
       }
       
@@ -279,6 +415,12 @@ namespace Tonic {
     
       TONIC_MAKE_CTRL_GEN_SETTERS(EffectType, bypass, setBypassCtrlGen);
       
+      //! Stop computing while the input is silent and the effect's tail has decayed. See TemplatedEffect::silenceDetection().
+      EffectType & silenceDetection( float tailTime, float threshold = 1e-5f ){
+        this->gen()->setSilenceDetection(tailTime, threshold);
+        return static_cast<EffectType&>(*this);
+      }
+      
       // Defaults to 1.0
       TONIC_MAKE_GEN_SETTERS(EffectType, wetLevel, setWetLevelGen);
       
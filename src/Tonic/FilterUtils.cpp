@@ -6,12 +6,231 @@
 
 #include "FilterUtils.h"
 
+#if (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+  #define TONIC_BIQUAD_SSE2
+  #include <emmintrin.h>
+#elif (defined (__ARM_NEON) || defined (__ARM_NEON__))
+  #define TONIC_BIQUAD_NEON
+  #include <arm_neon.h>
+#endif
+
 namespace Tonic {
-  
-  Biquad::Biquad(){
-    memset(coef_, 0, 5 * sizeof(TonicFloat));
-    inputVec_.resize(kSynthesisBlockSize + 4, 1, 0);
-    outputVec_.resize(kSynthesisBlockSize + 4, 1, 0);
+
+  Biquad::Biquad( unsigned int nSections ) :
+    nSections_(nSections == 2 ? 2 : 1),
+    nChannels_(1)
+  {
+    memset(coef_, 0, sizeof(coef_));
+    reset();
   }
-  
-}
\ No newline at end of file
+
+  namespace {
+
+    // -- 4-lane vector primitives for the biquad kernel --
+
+#if defined (TONIC_BIQUAD_SSE2)
+
+    typedef __m128 Lanes_;
+
+    inline Lanes_ lanesLoad( const TonicFloat * p ){ return _mm_loadu_ps(p); }
+    inline void lanesStore( TonicFloat * p, Lanes_ a ){ _mm_storeu_ps(p, a); }
+    inline Lanes_ lanesAdd( Lanes_ a, Lanes_ b ){ return _mm_add_ps(a, b); }
+    inline Lanes_ lanesSub( Lanes_ a, Lanes_ b ){ return _mm_sub_ps(a, b); }
+    inline Lanes_ lanesMul( Lanes_ a, Lanes_ b ){ return _mm_mul_ps(a, b); }
+    inline Lanes_ lanesSelect( Lanes_ mask, Lanes_ a, Lanes_ b ){ return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+    // [in0, y0, y1, y2]
+    inline Lanes_ lanesFeedMono( const TonicFloat * in, Lanes_ y ){
+      return _mm_move_ss(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(y), 4)), _mm_load_ss(in));
+    }
+
+    // [in0, in1, y0, y1]
+    inline Lanes_ lanesFeedStereo( const TonicFloat * in, Lanes_ y ){
+      return _mm_shuffle_ps(_mm_loadl_pi(_mm_setzero_ps(), (const __m64*)in), y, _MM_SHUFFLE(1, 0, 1, 0));
+    }
+
+    inline void lanesStoreLane0( TonicFloat * out, Lanes_ y ){ _mm_store_ss(out, y); }
+    inline void lanesStoreLane1( TonicFloat * out, Lanes_ y ){ _mm_store_ss(out, _mm_shuffle_ps(y, y, _MM_SHUFFLE(1, 1, 1, 1))); }
+    inline void lanesStoreLanes01( TonicFloat * out, Lanes_ y ){ _mm_storel_pi((__m64*)out, y); }
+    inline void lanesStoreLanes23( TonicFloat * out, Lanes_ y ){ _mm_storeh_pi((__m64*)out, y); }
+
+#elif defined (TONIC_BIQUAD_NEON)
+
+    typedef float32x4_t Lanes_;
+
+    inline Lanes_ lanesLoad( const TonicFloat * p ){ return vld1q_f32(p); }
+    inline void lanesStore( TonicFloat * p, Lanes_ a ){ vst1q_f32(p, a); }
+    inline Lanes_ lanesAdd( Lanes_ a, Lanes_ b ){ return vaddq_f32(a, b); }
+    inline Lanes_ lanesSub( Lanes_ a, Lanes_ b ){ return vsubq_f32(a, b); }
+    inline Lanes_ lanesMul( Lanes_ a, Lanes_ b ){ return vmulq_f32(a, b); }
+    inline Lanes_ lanesSelect( Lanes_ mask, Lanes_ a, Lanes_ b ){ return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+
+    inline Lanes_ lanesFeedMono( const TonicFloat * in, Lanes_ y ){
+      return vsetq_lane_f32(*in, vextq_f32(vdupq_n_f32(0), y, 3), 0);
+    }
+
+    inline Lanes_ lanesFeedStereo( const TonicFloat * in, Lanes_ y ){
+      return vcombine_f32(vld1_f32(in), vget_low_f32(y));
+    }
+
+    inline void lanesStoreLane0( TonicFloat * out, Lanes_ y ){ vst1q_lane_f32(out, y, 0); }
+    inline void lanesStoreLane1( TonicFloat * out, Lanes_ y ){ vst1q_lane_f32(out, y, 1); }
+    inline void lanesStoreLanes01( TonicFloat * out, Lanes_ y ){ vst1_f32(out, vget_low_f32(y)); }
+    inline void lanesStoreLanes23( TonicFloat * out, Lanes_ y ){ vst1_f32(out, vget_high_f32(y)); }
+
+#else
+
+    struct Lanes_ { TonicFloat v[4]; };
+
+    inline Lanes_ lanesLoad( const TonicFloat * p ){ Lanes_ r; memcpy(r.v, p, sizeof(r.v)); return r; }
+    inline void lanesStore( TonicFloat * p, Lanes_ a ){ memcpy(p, a.v, sizeof(a.v)); }
+    inline Lanes_ lanesAdd( Lanes_ a, Lanes_ b ){ for (int i=0; i<4; i++) a.v[i] += b.v[i]; return a; }
+    inline Lanes_ lanesSub( Lanes_ a, Lanes_ b ){ for (int i=0; i<4; i++) a.v[i] -= b.v[i]; return a; }
+    inline Lanes_ lanesMul( Lanes_ a, Lanes_ b ){ for (int i=0; i<4; i++) a.v[i] *= b.v[i]; return a; }
+
+    inline Lanes_ lanesSelect( Lanes_ mask, Lanes_ a, Lanes_ b ){
+      TonicUInt32 bits[4];
+      memcpy(bits, mask.v, sizeof(bits));
+      for (int i=0; i<4; i++) if (!bits[i]) a.v[i] = b.v[i];
+      return a;
+    }
+
+    inline Lanes_ lanesFeedMono( const TonicFloat * in, Lanes_ y ){
+      Lanes_ r = {{ in[0], y.v[0], y.v[1], y.v[2] }};
+      return r;
+    }
+
+    inline Lanes_ lanesFeedStereo( const TonicFloat * in, Lanes_ y ){
+      Lanes_ r = {{ in[0], in[1], y.v[0], y.v[1] }};
+      return r;
+    }
+
+    inline void lanesStoreLane0( TonicFloat * out, Lanes_ y ){ out[0] = y.v[0]; }
+    inline void lanesStoreLane1( TonicFloat * out, Lanes_ y ){ out[0] = y.v[1]; }
+    inline void lanesStoreLanes01( TonicFloat * out, Lanes_ y ){ out[0] = y.v[0]; out[1] = y.v[1]; }
+    inline void lanesStoreLanes23( TonicFloat * out, Lanes_ y ){ out[0] = y.v[2]; out[1] = y.v[3]; }
+
+#endif
+
+    //! All bits set in the first n lanes, for lanesSelect
+    inline Lanes_ lanesFirst( unsigned int n ){
+      TonicUInt32 bits[4];
+      TonicFloat mask[4];
+      for (unsigned int i=0; i<4; i++) bits[i] = i < n ? 0xFFFFFFFF : 0;
+      memcpy(mask, bits, sizeof(mask));
+      return lanesLoad(mask);
+    }
+
+    //! One TDF-II step of every lane. c holds b0, b1, b2, a1, a2.
+    inline Lanes_ biquadStep( Lanes_ x, const Lanes_ * c, Lanes_ & z1, Lanes_ & z2 ){
+      Lanes_ y = lanesAdd(lanesMul(c[0], x), z1);
+      z1 = lanesAdd(lanesSub(lanesMul(c[1], x), lanesMul(c[3], y)), z2);
+      z2 = lanesSub(lanesMul(c[2], x), lanesMul(c[4], y));
+      return y;
+    }
+
+    //! Input of the next step: the next input frame for the first section, each section's output for the one after it
+    template<unsigned int C>
+    inline Lanes_ biquadFeed( const TonicFloat * in, Lanes_ y ){
+      return C == 1 ? lanesFeedMono(in, y) : lanesFeedStereo(in, y);
+    }
+
+    //! Store the output frame from the last section's lanes
+    template<unsigned int C, unsigned int S>
+    inline void biquadStoreOutput( TonicFloat * out, Lanes_ y ){
+      if (C == 1){
+        if (S == 1) lanesStoreLane0(out, y); else lanesStoreLane1(out, y);
+      }
+      else{
+        if (S == 1) lanesStoreLanes01(out, y); else lanesStoreLanes23(out, y);
+      }
+    }
+
+    //! Filter nFrames frames of C channels through S sections. Lane s * C + c runs section s on channel c.
+    template<unsigned int C, unsigned int S>
+    void biquadLanes( const TonicFloat * in, TonicFloat * out, unsigned int nFrames, const Lanes_ * c, TonicFloat * z1State, TonicFloat * z2State ){
+
+      const TonicFloat zeros[4] = { 0, 0, 0, 0 };
+
+      Lanes_ z1 = lanesLoad(z1State);
+      Lanes_ z2 = lanesLoad(z2State);
+      Lanes_ y = lanesLoad(zeros);
+
+      if (S == 1){
+        for (unsigned int i=0; i<nFrames; i++){
+          y = biquadStep(biquadFeed<C>(in + i*C, y), c, z1, z2);
+          biquadStoreOutput<C, S>(out + i*C, y);
+        }
+      }
+      else{
+
+        // The second section runs one frame behind the first. The first step only advances the
+        // first section and the last step only the second, so no latency is added.
+        const Lanes_ firstSection = lanesFirst(C);
+        Lanes_ lastZ1 = z1;
+        Lanes_ lastZ2 = z2;
+
+        y = biquadStep(biquadFeed<C>(in, y), c, z1, z2);
+        z1 = lanesSelect(firstSection, z1, lastZ1);
+        z2 = lanesSelect(firstSection, z2, lastZ2);
+
+        for (unsigned int i=1; i<nFrames; i++){
+          y = biquadStep(biquadFeed<C>(in + i*C, y), c, z1, z2);
+          biquadStoreOutput<C, S>(out + (i-1)*C, y);
+        }
+
+        lastZ1 = z1;
+        lastZ2 = z2;
+        y = biquadStep(biquadFeed<C>(zeros, y), c, z1, z2);
+        z1 = lanesSelect(firstSection, lastZ1, z1);
+        z2 = lanesSelect(firstSection, lastZ2, z2);
+        biquadStoreOutput<C, S>(out + (nFrames-1)*C, y);
+      }
+
+      lanesStore(z1State, z1);
+      lanesStore(z2State, z2);
+    }
+
+  }
+
+  void Biquad::filter( const TonicFrames &inFrames, TonicFrames &outFrames ){
+
+    if (inFrames.channels() != nChannels_){
+      setIsStereo(inFrames.channels() == 2);
+    }
+
+    const unsigned int nFrames = synthesisBlockSize();
+    if (nFrames == 0) return;
+
+    // spread the coefficients over the lanes, unused lanes get zero
+    Lanes_ c[5];
+    for (unsigned int k=0; k<5; k++){
+      TonicFloat laneCoef[4];
+      for (unsigned int lane=0; lane<4; lane++){
+        unsigned int section = lane / nChannels_;
+        laneCoef[lane] = section < nSections_ ? coef_[section][k] : 0;
+      }
+      c[k] = lanesLoad(laneCoef);
+    }
+
+    const TonicFloat * in = &inFrames[0];
+    TonicFloat * out = &outFrames[0];
+
+    if (nChannels_ == 1){
+      if (nSections_ == 1) biquadLanes<1, 1>(in, out, nFrames, c, z1_, z2_);
+      else biquadLanes<1, 2>(in, out, nFrames, c, z1_, z2_);
+    }
+    else{
+      if (nSections_ == 1) biquadLanes<2, 1>(in, out, nFrames, c, z1_, z2_);
+      else biquadLanes<2, 2>(in, out, nFrames, c, z1_, z2_);
+    }
+
+#ifdef TONIC_DEBUG
+    if(outFrames(0,0) != outFrames(0,0)){
+      Tonic::error("Biquad::filter NaN detected.", false);
+    }
+#endif
+
+  }
+
+}
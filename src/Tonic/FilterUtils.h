@@ -15,14 +15,15 @@
 namespace Tonic {
   
   //! Calculate coefficient for a pole with given time constant to reach -60dB delta in t60s seconds
-  inline static TonicFloat t60ToOnePoleCoef( TonicFloat t60s ){
-    float coef = expf(-1.0f/((t60s/6.91f) * sampleRate()));
+  /*! rate is the sample rate the filter runs at. Generators should pass their own sampleRate_. */
+  inline static TonicFloat t60ToOnePoleCoef( TonicFloat t60s, TonicFloat rate = Tonic::sampleRate() ){
+    float coef = expf(-1.0f/((t60s/6.91f) * rate));
     return (coef == coef) ? coef : 0.f; // catch NaN
   }
   
   //! Calculate coefficient for a pole with a given desired cutoff in hz
-  inline static TonicFloat cutoffToOnePoleCoef( TonicFloat cutoffHz ){
-    return clamp(expf(-TWO_PI*cutoffHz/sampleRate()), 0.f, 1.f);
+  inline static TonicFloat cutoffToOnePoleCoef( TonicFloat cutoffHz, TonicFloat rate = Tonic::sampleRate() ){
+    return clamp(expf(-TWO_PI*cutoffHz/rate), 0.f, 1.f);
   }
   
   //! Tick one sample through one-pole lowpass filter
@@ -45,14 +46,14 @@ namespace Tonic {
  
       And be normalized for a cutoff of 1 rad/s.
    
-      fc is the desired frequency cutoff in Hz.
+      fc is the desired frequency cutoff in Hz, rate is the sample rate the filter runs at.
    
       coef_out is a pointer to a TonicFloat array of length 5. No bounds checking is performed.
  
   */
-  inline static void bltCoef( TonicFloat b2, TonicFloat b1, TonicFloat b0, TonicFloat a1, TonicFloat a0, TonicFloat fc, TonicFloat *coef_out)
+  inline static void bltCoef( TonicFloat b2, TonicFloat b1, TonicFloat b0, TonicFloat a1, TonicFloat a0, TonicFloat fc, TonicFloat *coef_out, TonicFloat rate = Tonic::sampleRate())
   {
-      TonicFloat sf = 1.0f/tanf(PI*fc/Tonic::sampleRate());
+      TonicFloat sf = 1.0f/tanf(PI*fc/rate);
       TonicFloat sfsq = sf*sf;
       TonicFloat norm = a0 + a1*sf + sfsq;
       coef_out[0] = (b0 + b1*sf + b2*sfsq)/norm;
@@ -65,22 +66,39 @@ namespace Tonic {
 #pragma mark - Biquad Class
   
   //! Biquad_ is an IIR biquad filter which provides a base object on which to build more advanced filters
+  /*!
+      Runs one or two cascaded sections, mono or stereo, in transposed direct form II, so the only
+      history is two state values per section and channel. Where SSE2 or NEON is available, every
+      channel and section is a lane of one 4-wide vector: the channels are filtered together, and
+      the second section works on the previous sample while the first works on the current one.
+   */
   class Biquad {
     
   protected:
     
-    TonicFloat coef_[5];
-    TonicFrames inputVec_;
-    TonicFrames outputVec_;
+    TonicFloat coef_[2][5];
+    
+    // TDF-II state, per lane. Lane section * nChannels_ + channel.
+    TonicFloat z1_[4];
+    TonicFloat z2_[4];
+    
+    unsigned int nSections_;
+    unsigned int nChannels_;
     
   public:
     
-    Biquad();
+    //! nSections is 1 or 2
+    Biquad( unsigned int nSections = 1 );
     
     void setIsStereo(bool stereo){
-      // resize vectors to match number of channels
-      inputVec_.resize(kSynthesisBlockSize + 4, stereo ? 2 : 1, 0);
-      outputVec_.resize(kSynthesisBlockSize + 4, stereo ? 2 : 1, 0);
+      nChannels_ = stereo ? 2 : 1;
+      reset();
+    }
+    
+    //! Clear the filter state
+    void reset(){
+      memset(z1_, 0, sizeof(z1_));
+      memset(z2_, 0, sizeof(z2_));
     }
     
     //! Set the coefficients for the filtering operation.
@@ -90,62 +108,24 @@ namespace Tonic {
              1 + a1*z^-1 + a2*z^-2
      */
     void setCoefficients( TonicFloat b0, TonicFloat b1, TonicFloat b2, TonicFloat a1, TonicFloat a2 );
-    void setCoefficients( TonicFloat *newCoef );
     
-    void filter( TonicFrames &inFrames, TonicFrames &outFrames );
+    //! Set the coefficients of one section, in the order b0, b1, b2, a1, a2
+    void setCoefficients( TonicFloat *newCoef, unsigned int section = 0 );
+    
+    //! Filter a block through all sections. inFrames and outFrames may be the same.
+    void filter( const TonicFrames &inFrames, TonicFrames &outFrames );
   };
   
   inline void Biquad::setCoefficients(TonicFloat b0, TonicFloat b1, TonicFloat b2, TonicFloat a1, TonicFloat a2){
-    coef_[0] = b0;
-    coef_[1] = b1;
-    coef_[2] = b2;
-    coef_[3] = a1;
-    coef_[4] = a2;
-  }
-  
-  inline void Biquad::setCoefficients(TonicFloat *newCoef){
-    memcpy(coef_, newCoef, 5 * sizeof(TonicFloat));
+    coef_[0][0] = b0;
+    coef_[0][1] = b1;
+    coef_[0][2] = b2;
+    coef_[0][3] = a1;
+    coef_[0][4] = a2;
   }
   
-  inline void Biquad::filter( TonicFrames &inFrames, TonicFrames &outFrames ){
-    
-    // initialize vectors
-    memcpy(&inputVec_[0], &inputVec_(kSynthesisBlockSize, 0), 2 * inputVec_.channels() * sizeof(TonicFloat));
-    memcpy(&inputVec_(2, 0), &inFrames[0], inFrames.size() * sizeof(TonicFloat));
-    memcpy(&outputVec_[0], &outputVec_(kSynthesisBlockSize, 0), 2 * outputVec_.channels() * sizeof(TonicFloat));
-    
-    // perform IIR filter
-    
-    unsigned int stride = inFrames.channels();
-    
-#ifdef USE_APPLE_ACCELERATE
-    for (unsigned int c=0; c<stride; c++){
-      vDSP_deq22(&inputVec_[0] + c, stride, coef_, &outputVec_[0] + c, stride, kSynthesisBlockSize);
-    }
-#else
-    
-    for (unsigned int c=0; c<stride; c++){
-      
-      TonicFloat* in = &inputVec_(2, c);
-      TonicFloat* out = &outputVec_(2, c);
-      
-      for (unsigned int i=0; i<kSynthesisBlockSize; i++){
-        *out = *(in)*coef_[0] + *(in-stride)*coef_[1] + *(in-2*stride)*coef_[2] - *(out-stride)*coef_[3] - *(out-2*stride)*coef_[4];
-        in += stride;
-        out += stride;
-      }
-      
-    }
-#endif
-
-#ifdef TONIC_DEBUG
-    if(outFrames(0,0) != outFrames(0,0)){
-      Tonic::error("Biquad::filter NaN detected.", false);
-    }
-#endif
-    
-    // copy to synthesis block
-    memcpy(&outFrames[0], &outputVec_(2,0), kSynthesisBlockSize * stride * sizeof(TonicFloat));
+  inline void Biquad::setCoefficients(TonicFloat *newCoef, unsigned int section){
+    memcpy(coef_[section], newCoef, 5 * sizeof(TonicFloat));
   }
   
   
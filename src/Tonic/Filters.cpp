@@ -18,9 +18,11 @@ namespace Tonic { namespace Tonic_{
     cutoff_(FixedValue(20000)),
     Q_(FixedValue(0.7071)),
     bypass_(ControlValue(0)),
-    bNormalizeGain_(true)
+    bNormalizeGain_(true),
+    lastCutoff_(-1),
+    lastQ_(-1),
+    lastNormalizeGain_(true)
   {
-    workspace_.resize(kSynthesisBlockSize, 1, 0);
   }
   
   void Filter_::setInput(Generator input){
@@ -45,16 +45,30 @@ namespace Tonic {
         
     protected:
       
-      TonicFrames workspace_;
-      
       Generator cutoff_;
       Generator Q_;
       ControlGenerator bypass_;
       
       bool bNormalizeGain_;
       
+      // parameters the current coefficients were computed for
+      TonicFloat lastCutoff_;
+      TonicFloat lastQ_;
+      bool lastNormalizeGain_;
+      
       void computeSynthesisBlock( const SynthesisContext_ & context );
       
+      //! True if coefficients for cutoff and Q need computing, i.e. they, gain normalization or the sample rate changed since the last call that returned true.
+      bool parametersChanged( TonicFloat cutoff, TonicFloat Q ){
+        if (cutoff == lastCutoff_ && Q == lastQ_ && bNormalizeGain_ == lastNormalizeGain_) return false;
+        lastCutoff_ = cutoff;
+        lastQ_ = Q;
+        lastNormalizeGain_ = bNormalizeGain_;
+        return true;
+      }
+      
+      void sampleRateChanged() { lastCutoff_ = -1; };
+      
       // subclasses override to compute new coefficients and apply filter
       virtual void applyFilter( TonicFloat cutoff, TonicFloat Q,  const SynthesisContext_ & context ) = 0;
       
@@ -62,12 +76,18 @@ namespace Tonic {
       
       Filter_();
       
+      void appendInputs( vector<Generator_*> & inputs ){
+        Effect_::appendInputs(inputs);
+        inputs.push_back(cutoff_.rawGenerator());
+        inputs.push_back(Q_.rawGenerator());
+      };
+
       // Overridden so output channel layout follows input channel layout
       virtual void setInput( Generator input );
       
       void setNormalizesGain( bool norm ) { bNormalizeGain_ = norm; };
-      void setCutoff( Generator cutoff ){ cutoff_ = cutoff; };
-      void setQ( Generator Q ){ Q_ = Q; }
+      void setCutoff( Generator cutoff ){ cutoff_ = cutoff; inputsChanged(); };
+      void setQ( Generator Q ){ Q_ = Q; inputsChanged(); }
       void setBypass( ControlGenerator bypass ){ bypass_ = bypass; };
 
             
@@ -82,11 +102,11 @@ namespace Tonic {
       // For now only using first frame of output. Setting coefficients each frame is very inefficient.
       // Updating cutoff every 64-samples is typically fast enough to avoid audible artifacts when sweeping filters.
       
-      cutoff_.tick(workspace_, context);
-      cCutoff = clamp(workspace_(0,0), 20, sampleRate()/2); // clamp to reasonable range
+      ScratchFrames_ workspace(context, 1);
+      
+      cCutoff = clamp(cutoff_.output(context, *workspace)(0,0), 20, sampleRate_/2); // clamp to reasonable range
       
-      Q_.tick(workspace_, context);
-      cQ = max(workspace_(0,0), 0.7071); // clamp to reasonable range
+      cQ = max(Q_.output(context, *workspace)(0,0), 0.7071); // clamp to reasonable range
       
       applyFilter(cCutoff, cQ, context);
       
@@ -102,18 +122,22 @@ namespace Tonic {
     private:
       
       TonicFloat lastOut_[2];
+      TonicFloat coef_;
       
     protected:
       inline void applyFilter( TonicFloat cutoff, TonicFloat Q, const SynthesisContext_ & context )
       {
         
-        TonicFloat *inptr = &dryFrames_[0];
+        const TonicFloat *inptr = &dryInput()[0];
         TonicFloat *outptr = &outputFrames_[0];
-        TonicFloat coef = cutoffToOnePoleCoef(cutoff);
+        if (parametersChanged(cutoff, Q)){
+          coef_ = cutoffToOnePoleCoef(cutoff, sampleRate_);
+        }
+        TonicFloat coef = coef_;
         TonicFloat norm = bNormalizeGain_ ? 1.0f - coef : 1.0f;
-        unsigned int nChannels = dryFrames_.channels();
+        unsigned int nChannels = dryInput().channels();
         
-        for (unsigned int i=0; i<kSynthesisBlockSize; i++){
+        for (unsigned int i=0; i<synthesisBlockSize(); i++){
           for (unsigned int c=0; c<nChannels; c++){
             lastOut_[c] = (norm * (*inptr++)) + (coef * lastOut_[c]);
             *outptr++ = lastOut_[c];
@@ -123,7 +147,7 @@ namespace Tonic {
       
     public:
       
-      LPF6_(){
+      LPF6_() : coef_(0) {
         lastOut_[0] = 0;
         lastOut_[1] = 0;
       }
@@ -140,19 +164,23 @@ namespace Tonic {
     private:
       
       TonicFloat lastOut_[2];
+      TonicFloat coef_;
       
     protected:
       
       inline void applyFilter( TonicFloat cutoff, TonicFloat Q, const SynthesisContext_ & context )
       {
         
-        TonicFloat *inptr = &dryFrames_[0];
+        const TonicFloat *inptr = &dryInput()[0];
         TonicFloat *outptr = &outputFrames_[0];
-        TonicFloat coef = 1.0f - cutoffToOnePoleCoef(cutoff);
+        if (parametersChanged(cutoff, Q)){
+          coef_ = 1.0f - cutoffToOnePoleCoef(cutoff, sampleRate_);
+        }
+        TonicFloat coef = coef_;
         TonicFloat norm = bNormalizeGain_ ? 1.0f - coef : 1.0f;
-        unsigned int nChannels = dryFrames_.channels();
+        unsigned int nChannels = dryInput().channels();
         
-        for (unsigned int i=0; i<kSynthesisBlockSize; i++){
+        for (unsigned int i=0; i<synthesisBlockSize(); i++){
           for (unsigned int c=0; c<nChannels; c++){
             lastOut_[c] = (norm * (*inptr++)) - (coef * lastOut_[c]);
             *outptr++ = lastOut_[c];
@@ -163,7 +191,7 @@ namespace Tonic {
       
     public:
       
-      HPF6_(){
+      HPF6_() : coef_(0) {
         lastOut_[0] = 0;
         lastOut_[1] = 0;
       }
@@ -185,13 +213,15 @@ namespace Tonic {
     protected:
       
       inline void applyFilter( TonicFloat cutoff, TonicFloat Q, const SynthesisContext_ & context ){
-        // set coefficients
-        TonicFloat newCoef[5];
-        bltCoef(0, 0, bNormalizeGain_ ? 1.0f/Q : 1.0f, 1.0f/Q, 1, cutoff, newCoef);
-        biquad_.setCoefficients(newCoef);
+        // set coefficients, unless cutoff and Q are the same as last block
+        if (parametersChanged(cutoff, Q)){
+          TonicFloat newCoef[5];
+          bltCoef(0, 0, bNormalizeGain_ ? 1.0f/Q : 1.0f, 1.0f/Q, 1, cutoff, newCoef, sampleRate_);
+          biquad_.setCoefficients(newCoef);
+        }
         
         // compute
-        biquad_.filter(dryFrames_, outputFrames_);
+        biquad_.filter(dryInput(), outputFrames_);
       }
       
     public:
@@ -213,34 +243,36 @@ namespace Tonic {
       
     private:
       
-      Biquad biquads_[2];
+      Biquad biquad_;
       
     protected:
       
       inline void applyFilter( TonicFloat cutoff, TonicFloat Q, const SynthesisContext_ & context ){
-        // set coefficients
-        TonicFloat newCoef[5];
+        // set coefficients, unless cutoff and Q are the same as last block
+        if (parametersChanged(cutoff, Q)){
+          TonicFloat newCoef[5];
         
-        // stage 1
-        bltCoef(0, 0, bNormalizeGain_ ? 1.0f/Q : 1.0f, 0.5412f/Q, 1, cutoff, newCoef);
-        biquads_[0].setCoefficients(newCoef);
+          // stage 1
+          bltCoef(0, 0, bNormalizeGain_ ? 1.0f/Q : 1.0f, 0.5412f/Q, 1, cutoff, newCoef, sampleRate_);
+          biquad_.setCoefficients(newCoef, 0);
         
-        // stage 2
-        bltCoef(0, 0, bNormalizeGain_ ? 1.0f/Q : 1.0f, 1.3066f/Q, 1, cutoff, newCoef);
-        biquads_[1].setCoefficients(newCoef);
+          // stage 2
+          bltCoef(0, 0, bNormalizeGain_ ? 1.0f/Q : 1.0f, 1.3066f/Q, 1, cutoff, newCoef, sampleRate_);
+          biquad_.setCoefficients(newCoef, 1);
+        }
         
-        // compute
-        biquads_[0].filter(dryFrames_, outputFrames_);
-        biquads_[1].filter(outputFrames_, outputFrames_);
+        // compute both stages in one pass
+        biquad_.filter(dryInput(), outputFrames_);
       }
       
     public:
       
+      LPF24_() : biquad_(2) {}
+      
       void setIsStereoInput( bool isStereoInput )
       {
         Filter_::setIsStereoInput(isStereoInput);
-        biquads_[0].setIsStereo(isStereoInput);
-        biquads_[1].setIsStereo(isStereoInput);
+        biquad_.setIsStereo(isStereoInput);
       }
 
       
@@ -261,13 +293,15 @@ namespace Tonic {
       
       inline void applyFilter( TonicFloat cutoff, TonicFloat Q, const SynthesisContext_ & context ){
         
-        // set coefficients
-        TonicFloat newCoef[5];
-        bltCoef(bNormalizeGain_ ? 1.0f/Q : 1.0f, 0, 0, 1.0f/Q, 1, cutoff, newCoef);
-        biquad_.setCoefficients(newCoef);
+        // set coefficients, unless cutoff and Q are the same as last block
+        if (parametersChanged(cutoff, Q)){
+          TonicFloat newCoef[5];
+          bltCoef(bNormalizeGain_ ? 1.0f/Q : 1.0f, 0, 0, 1.0f/Q, 1, cutoff, newCoef, sampleRate_);
+          biquad_.setCoefficients(newCoef);
+        }
         
         // compute
-        biquad_.filter(dryFrames_, outputFrames_);
+        biquad_.filter(dryInput(), outputFrames_);
       }
       
     public:
@@ -289,34 +323,36 @@ namespace Tonic {
       
     private:
       
-      Biquad biquads_[2];
+      Biquad biquad_;
       
     protected:
       
       inline void applyFilter( TonicFloat cutoff, TonicFloat Q, const SynthesisContext_ & context ){
-        // set coefficients
-        TonicFloat newCoef[5];
+        // set coefficients, unless cutoff and Q are the same as last block
+        if (parametersChanged(cutoff, Q)){
+          TonicFloat newCoef[5];
         
-        // stage 1
-        bltCoef(bNormalizeGain_ ? 1.0f/Q : 1.0f, 0, 0, 0.5412f/Q, 1, cutoff, newCoef);
-        biquads_[0].setCoefficients(newCoef);
+          // stage 1
+          bltCoef(bNormalizeGain_ ? 1.0f/Q : 1.0f, 0, 0, 0.5412f/Q, 1, cutoff, newCoef, sampleRate_);
+          biquad_.setCoefficients(newCoef, 0);
         
-        // stage 2
-        bltCoef(bNormalizeGain_ ? 1.0f/Q : 1.0f, 0, 0, 1.3066f/Q, 1, cutoff, newCoef);
-        biquads_[1].setCoefficients(newCoef);
+          // stage 2
+          bltCoef(bNormalizeGain_ ? 1.0f/Q : 1.0f, 0, 0, 1.3066f/Q, 1, cutoff, newCoef, sampleRate_);
+          biquad_.setCoefficients(newCoef, 1);
+        }
         
-        // compute
-        biquads_[0].filter(dryFrames_, outputFrames_);
-        biquads_[1].filter(outputFrames_, outputFrames_);
+        // compute both stages in one pass
+        biquad_.filter(dryInput(), outputFrames_);
       }
       
     public:
       
+      HPF24_() : biquad_(2) {}
+      
       void setIsStereoInput( bool isStereoInput )
       {
         Filter_::setIsStereoInput(isStereoInput);
-        biquads_[0].setIsStereo(isStereoInput);
-        biquads_[1].setIsStereo(isStereoInput);
+        biquad_.setIsStereo(isStereoInput);
       }
       
     };
@@ -337,13 +373,15 @@ namespace Tonic {
       
       inline void applyFilter( TonicFloat cutoff, TonicFloat Q, const SynthesisContext_ & context ){
         
-        // set coefficients
-        TonicFloat newCoef[5];
-        bltCoef(0, bNormalizeGain_ ? 1.0f/Q : 1.0f, 0, 1.0f/Q, 1, cutoff, newCoef);
-        biquad_.setCoefficients(newCoef);
+        // set coefficients, unless cutoff and Q are the same as last block
+        if (parametersChanged(cutoff, Q)){
+          TonicFloat newCoef[5];
+          bltCoef(0, bNormalizeGain_ ? 1.0f/Q : 1.0f, 0, 1.0f/Q, 1, cutoff, newCoef, sampleRate_);
+          biquad_.setCoefficients(newCoef);
+        }
         
         // compute
-        biquad_.filter(dryFrames_, outputFrames_);
+        biquad_.filter(dryInput(), outputFrames_);
       }
       
     public:
@@ -365,34 +403,36 @@ namespace Tonic {
       
     private:
       
-      Biquad biquads_[2];
+      Biquad biquad_;
       
     protected:
       
       inline void applyFilter( TonicFloat cutoff, TonicFloat Q, const SynthesisContext_ & context ){
-        // set coefficients
-        TonicFloat newCoef[5];
+        // set coefficients, unless cutoff and Q are the same as last block
+        if (parametersChanged(cutoff, Q)){
+          TonicFloat newCoef[5];
         
-        // stage 1
-        bltCoef(0, bNormalizeGain_ ? 1.0f/Q : 1.0f, 0, 0.5412f/Q, 1, cutoff, newCoef);
-        biquads_[0].setCoefficients(newCoef);
+          // stage 1
+          bltCoef(0, bNormalizeGain_ ? 1.0f/Q : 1.0f, 0, 0.5412f/Q, 1, cutoff, newCoef, sampleRate_);
+          biquad_.setCoefficients(newCoef, 0);
         
-        // stage 2
-        bltCoef(0, bNormalizeGain_ ? 1.0f/Q : 1.0f, 0, 1.3066f/Q, 1, cutoff, newCoef);
-        biquads_[1].setCoefficients(newCoef);
+          // stage 2
+          bltCoef(0, bNormalizeGain_ ? 1.0f/Q : 1.0f, 0, 1.3066f/Q, 1, cutoff, newCoef, sampleRate_);
+          biquad_.setCoefficients(newCoef, 1);
+        }
         
-        // compute
-        biquads_[0].filter(dryFrames_, outputFrames_);
-        biquads_[1].filter(outputFrames_, outputFrames_);
+        // compute both stages in one pass
+        biquad_.filter(dryInput(), outputFrames_);
       }
       
     public:
       
+      BPF24_() : biquad_(2) {}
+      
       void setIsStereoInput( bool isStereoInput )
       {
         Filter_::setIsStereoInput(isStereoInput);
-        biquads_[0].setIsStereo(isStereoInput);
-        biquads_[1].setIsStereo(isStereoInput);
+        biquad_.setIsStereo(isStereoInput);
       }
       
     };
@@ -413,13 +453,15 @@ namespace Tonic {
       
       inline void applyFilter( TonicFloat cutoff, TonicFloat Q, const SynthesisContext_ & context ){
         
-        // set coefficients
-        TonicFloat newCoef[5];
-        bltCoef(1.0f, 0.0f, 1.0f, 1.0f/Q, 1, cutoff, newCoef);
-        biquad_.setCoefficients(newCoef);
+        // set coefficients, unless cutoff and Q are the same as last block
+        if (parametersChanged(cutoff, Q)){
+          TonicFloat newCoef[5];
+          bltCoef(1.0f, 0.0f, 1.0f, 1.0f/Q, 1, cutoff, newCoef, sampleRate_);
+          biquad_.setCoefficients(newCoef);
+        }
         
         // compute
-        biquad_.filter(dryFrames_, outputFrames_);
+        biquad_.filter(dryInput(), outputFrames_);
       }
       
     public:
@@ -441,34 +483,36 @@ namespace Tonic {
       
     private:
       
-      Biquad biquads_[2];
+      Biquad biquad_;
       
     protected:
       
       inline void applyFilter( TonicFloat cutoff, TonicFloat Q, const SynthesisContext_ & context ){
-        // set coefficients
-        TonicFloat newCoef[5];
+        // set coefficients, unless cutoff and Q are the same as last block
+        if (parametersChanged(cutoff, Q)){
+          TonicFloat newCoef[5];
         
-        // stage 1
-        bltCoef(1.0f, 0.0f, 1.0f, 0.5412f/Q, 1, cutoff, newCoef);
-        biquads_[0].setCoefficients(newCoef);
+          // stage 1
+          bltCoef(1.0f, 0.0f, 1.0f, 0.5412f/Q, 1, cutoff, newCoef, sampleRate_);
+          biquad_.setCoefficients(newCoef, 0);
         
-        // stage 2
-        bltCoef(1.0f, 0.0f, 1.0f, 1.3066f/Q, 1, cutoff, newCoef);
-        biquads_[1].setCoefficients(newCoef);
+          // stage 2
+          bltCoef(1.0f, 0.0f, 1.0f, 1.3066f/Q, 1, cutoff, newCoef, sampleRate_);
+          biquad_.setCoefficients(newCoef, 1);
+        }
         
-        // compute
-        biquads_[0].filter(dryFrames_, outputFrames_);
-        biquads_[1].filter(outputFrames_, outputFrames_);
+        // compute both stages in one pass
+        biquad_.filter(dryInput(), outputFrames_);
       }
       
     public:
       
+      BRF24_() : biquad_(2) {}
+      
       void setIsStereoInput( bool isStereoInput )
       {
         Filter_::setIsStereoInput(isStereoInput);
-        biquads_[0].setIsStereo(isStereoInput);
-        biquads_[1].setIsStereo(isStereoInput);
+        biquad_.setIsStereo(isStereoInput);
       }
       
     };
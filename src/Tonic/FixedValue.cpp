@@ -15,8 +15,9 @@ namespace Tonic {
   
   namespace Tonic_ {
     
-    FixedValue_::FixedValue_(float val){
+    FixedValue_::FixedValue_(float val) : isFixed_(true), fixedValue_(val) {
       valueGen = ControlValue(val);
+      isConstantOutput_ = true; // zero-filled until the value is first ticked
     }
     
     
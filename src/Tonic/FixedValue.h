@@ -25,6 +25,16 @@ namespace Tonic {
       
       ControlGenerator valueGen;
       
+      // set by setValue(TonicFloat): the output never changes from fixedValue_
+      bool        isFixed_;
+      TonicFloat  fixedValue_;
+      
+      // A Multiplier_ reading this schedules it differently once canBecomeSilent() changes.
+      // Only then do schedules containing it have to be recompiled, not on every new value.
+      void silenceabilityChanged( bool couldBeSilent ){
+        if (canBecomeSilent() != couldBeSilent) inputsChanged();
+      }
+      
       void computeSynthesisBlock( const SynthesisContext_ & context );
 
         
@@ -33,28 +43,32 @@ namespace Tonic {
       FixedValue_(float TonicFloat = 0);
     
       void setValue(ControlGenerator val){
+        bool couldBeSilent = canBecomeSilent();
         valueGen = val;
+        isFixed_ = false;
+        silenceabilityChanged(couldBeSilent);
       }
+      
+      void setValue(TonicFloat val){
+        bool couldBeSilent = canBecomeSilent();
+        valueGen = ControlValue(val);
+        isFixed_ = true;
+        fixedValue_ = val;
+        silenceabilityChanged(couldBeSilent);
+      }
+      
+      //! Only a fixed zero, or a value driven by a control that may reach zero, can be silent
+      bool canBecomeSilent(){ return !isFixed_ || fixedValue_ == 0; };
 
     };
     
     inline void FixedValue_::computeSynthesisBlock( const SynthesisContext_ & context ){
       
-      float* buffStart = &outputFrames_[0];
-      
       ControlGeneratorOutput valueOutput = valueGen.tick(context);
       
+      // output is always constant - only refill when the value actually changes
       if (valueOutput.triggered){
-        
-#ifdef USE_APPLE_ACCELERATE
-        
-        vDSP_vfill( &valueOutput.value , buffStart, 1, outputFrames_.size());
-        
-#else
-        
-        std::fill(buffStart, buffStart + outputFrames_.size(), valueOutput.value);
-        
-#endif
+        setConstantOutput(valueOutput.value);
       }
     }
 
@@ -67,7 +81,7 @@ namespace Tonic {
       setValue(val);
     }
     FixedValue& setValue(float val){
-      gen()->setValue(ControlValue(val));
+      gen()->setValue((TonicFloat)val);
       return *this;
     }
     FixedValue& setValue(ControlGenerator val){
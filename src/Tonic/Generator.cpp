@@ -13,15 +13,16 @@
 
 namespace Tonic{ namespace Tonic_{
   
-  Generator_::Generator_() : lastFrameIndex_(0), isStereoOutput_(false){
-    outputFrames_.resize(kSynthesisBlockSize, 1, 0);
+  Generator_::Generator_() : lastFrameIndex_(0), isStereoOutput_(false), isConstantOutput_(false), sampleRate_(Tonic::sampleRate()), inputsRevision_(0), nodeId_(newNodeId()){
+    outputFrames_.resize(synthesisBlockSize(), 1, 0);
   }
   
   Generator_::~Generator_() {}
   
   void Generator_::setIsStereoOutput(bool stereo){
     if (stereo != isStereoOutput_){
-      outputFrames_.resize(kSynthesisBlockSize, stereo ? 2 : 1, 0);
+      outputFrames_.resize(synthesisBlockSize(), stereo ? 2 : 1, 0);
+      isConstantOutput_ = false;
     }
     isStereoOutput_ = stereo;
   }
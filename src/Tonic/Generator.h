@@ -13,12 +13,14 @@
 #define TONIC_GENERATOR_H
 
 #include "TonicFrames.h"
+#include "ScratchFrames.h"
+#include "Profiler.h"
 #include <cmath>
 namespace Tonic {
 
   namespace Tonic_{
 
-    class Generator_{
+    class Generator_ : public RefCounted_ {
       
     public:
       
@@ -27,8 +29,53 @@ namespace Tonic {
       
       virtual void tick( TonicFrames& frames, const SynthesisContext_ &context );
       
+      //! Compute a new block into outputFrames_, unless it was already computed for this context
+      /*!
+          Override this rather than tick() if a generator needs custom reuse behavior,
+          e.g. to pre-tick inputs before computeSynthesisBlock() is called.
+       */
+      virtual void updateOutput( const SynthesisContext_ &context );
+      
+      //! Append the generators this generator reads from. Used to compile execution schedules.
+      /*!
+          Generators that aren't reported here are still computed on demand when ticked,
+          they just don't get a slot in the schedule.
+       */
+      virtual void appendInputs( vector<Generator_*> & inputs ) {};
+      
+      //! Append inputs left out of appendInputs() that are still computed on demand, e.g. ones behind a gate.
+      /*! Used to size the scratch stack, which must cover borrows nested through every input. */
+      virtual void appendUnscheduledInputs( vector<Generator_*> & inputs ) {};
+      
+      //! Incremented whenever this generator's inputs are replaced, added or removed.
+      /*! Compiled schedules compare against this to know they are stale and must not be run. */
+      int inputsRevision() const { return *(volatile TONIC_ATOMIC_INT_T*)&inputsRevision_; }
+      
+      //! Unique for the life of the process, unlike the address. Identifies this node in profiles.
+      int nodeId() const { return nodeId_; }
+      
       bool isStereoOutput(){ return isStereoOutput_; };
       
+      //! Most recently computed block. Only valid after updateOutput() for the current context.
+      const TonicFrames & outputFrames() const { return outputFrames_; };
+      
+      //! True if every sample of the most recent block, in every channel, equals outputFrames()[0].
+      /*!
+          Consumers can use this to replace per-sample work on the block with scalar work.
+          The block itself is always filled, so ignoring this flag is also correct.
+       */
+      bool isConstantOutput() const { return isConstantOutput_; };
+      
+      //! True if the most recent block is constant zero, e.g. an idle envelope or a finished sample.
+      bool isSilentOutput() const { return isConstantOutput_ && outputFrames_[0] == 0.f; };
+      
+      //! Whether this generator may output whole blocks of silence.
+      /*!
+          Generators that skip their other inputs while one input is silent (see Multiplier_)
+          evaluate these inputs first, and only schedule these.
+       */
+      virtual bool canBecomeSilent() { return false; };
+      
       // set stereo/mono - changes number of channels in outputFrames_
       // subclasses should call in constructor to determine channel output
       virtual void setIsStereoOutput( bool stereo );
@@ -38,24 +85,63 @@ namespace Tonic {
       // override point for defining generator behavior
       // subclasses should implment to fill frames with new data
       virtual void computeSynthesisBlock( const SynthesisContext_ &context ) {};
+      
+      // called when the context's sample rate differs from the one this generator last ran at,
+      // after sampleRate_ has been updated. Subclasses should recompute rate-dependent state here.
+      virtual void sampleRateChanged() {};
+      
+      // fill the output block with value and mark it constant. The fill is skipped if the
+      // previous block was already constant at the same value.
+      void setConstantOutput( TonicFloat value ){
+        if (!isConstantOutput_ || outputFrames_[0] != value){
+          outputFrames_.fill(value);
+        }
+        isConstantOutput_ = true;
+      }
+      
+      // call before computing a block. Cheap when the rate hasn't changed.
+      void syncSampleRate( const SynthesisContext_ &context ){
+        if (context.sampleRate != sampleRate_){
+          sampleRate_ = context.sampleRate;
+          sampleRateChanged();
+        }
+      }
 
       
+      // setters that connect or disconnect inputs call this, so schedules containing this generator are recompiled
+      void inputsChanged() { TONIC_ATOMIC_INCREMENT(inputsRevision_); }
+      
       bool            isStereoOutput_;
+      bool            isConstantOutput_;    // subclasses producing constant blocks maintain this
       TonicFrames     outputFrames_;
       unsigned long   lastFrameIndex_;
+      TonicFloat      sampleRate_;
+      
+    private:
+      
+      TONIC_ATOMIC_INT_T inputsRevision_;
+      int                nodeId_;
       
     };
     
     inline void Generator_::tick(TonicFrames &frames, const SynthesisContext_ &context ){
       
+      updateOutput(context);
+    
+      // copy synthesis block to frames passed in
+      frames.copy(outputFrames_);
+      
+    }
+    
+    inline void Generator_::updateOutput( const SynthesisContext_ &context ){
+      
       // check context to see if we need new frames
       if (context.forceNewOutput || lastFrameIndex_ != context.elapsedFrames){
+        ProfilerScope_ profile(context.profiler, nodeId(), typeid(*this));
+        syncSampleRate(context);
         computeSynthesisBlock(context);
         lastFrameIndex_ = context.elapsedFrames;
       }
-    
-      // copy synthesis block to frames passed in
-      frames.copy(outputFrames_);
       
     }
 
@@ -68,6 +154,27 @@ namespace Tonic {
     
     Generator( Tonic_::Generator_ * gen = new Tonic_::Generator_ ) : TonicSmartPointer<Tonic_::Generator_>(gen) {}
     
+    Generator( const Generator& r ) : TonicSmartPointer<Tonic_::Generator_>(r) {}
+    
+    Generator& operator=(const Generator& r){
+      TonicSmartPointer<Tonic_::Generator_>::operator=(r);
+      return *this;
+    }
+    
+#if TONIC_HAS_CPP_11
+    Generator( Generator&& r ) : TonicSmartPointer<Tonic_::Generator_>(std::move(r)) {}
+    
+    Generator& operator=(Generator&& r){
+      TonicSmartPointer<Tonic_::Generator_>::operator=(std::move(r));
+      return *this;
+    }
+#endif
+    
+    //! The DSP-level generator, for graph traversal
+    Tonic_::Generator_ * rawGenerator() const {
+      return obj;
+    }
+    
     inline bool isStereoOutput(){
       return obj->isStereoOutput();
     }
@@ -75,6 +182,40 @@ namespace Tonic {
     virtual void tick(TonicFrames& frames, const Tonic_::SynthesisContext_ & context){
       obj->tick(frames, context);
     }
+    
+    //! Whether the output block most recently returned by output() or tick() is constant. See Generator_::isConstantOutput().
+    bool isConstantOutput() const {
+      return obj->isConstantOutput();
+    }
+    
+    //! Whether the output block most recently returned by output() or tick() is silent. See Generator_::isSilentOutput().
+    bool isSilentOutput() const {
+      return obj->isSilentOutput();
+    }
+    
+    //! Read-only view of the output block for this context, computed if necessary.
+    /*!
+        Unlike tick(), nothing is copied. The view is in this generator's own channel layout
+        and stays valid until the generator computes its next block.
+     */
+    const TonicFrames & output(const Tonic_::SynthesisContext_ & context){
+      obj->updateOutput(context);
+      return obj->outputFrames();
+    }
+    
+    //! Read-only view of the output block in the channel layout of workspace.
+    /*!
+        If the layouts match the output is returned directly, otherwise it is converted into
+        workspace (as by TonicFrames::copy) and workspace is returned.
+     */
+    const TonicFrames & output(const Tonic_::SynthesisContext_ & context, TonicFrames & workspace){
+      const TonicFrames & frames = output(context);
+      if (frames.channels() == workspace.channels()){
+        return frames;
+      }
+      workspace.copy(frames);
+      return workspace;
+    }
 
   };
   
@@ -100,7 +241,7 @@ namespace Tonic {
                                                                                         \
                                                                                         \
   generatorClassName& methodNameInGenerator(Generator arg){                             \
-    this->gen()->methodNameInGenerator_(arg);                                           \
+    this->gen()->methodNameInGenerator_(TONIC_MOVE(arg));                               \
     return static_cast<generatorClassName&>(*this);                                     \
   }                                                                                     \
                                                                                         \
@@ -0,0 +1,77 @@
+//
+//  GraphSchedule.cpp
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#include "GraphSchedule.h"
+
+namespace Tonic { namespace Tonic_ {
+
+  GraphSchedule_::GraphSchedule_() : revision_(0), scratchDepth_(0) {}
+
+  void GraphSchedule_::compile( Generator_ * root ){
+
+    nodes_.clear();
+    revision_ = 0;
+
+    std::set<Generator_*> visited;
+    if (root){
+      appendNode(root, visited);
+    }
+    
+    scratchDepth_ = scratchDepth(root);
+  }
+  
+  unsigned int GraphSchedule_::scratchDepth( Generator_ * root ){
+    if (!root) return 0;
+    std::map<Generator_*, unsigned int> lengths;
+    return kScratchFramesPerNode * chainLength(root, lengths);
+  }
+  
+  // number of generators on the longest chain of inputs starting at node
+  unsigned int GraphSchedule_::chainLength( Generator_ * node, std::map<Generator_*, unsigned int> & lengths ){
+    
+    std::map<Generator_*, unsigned int>::iterator it = lengths.find(node);
+    if (it != lengths.end()) return it->second;
+    
+    // guards against cycles while node's inputs are walked
+    lengths[node] = 1;
+    
+    vector<Generator_*> inputs;
+    node->appendInputs(inputs);
+    node->appendUnscheduledInputs(inputs);
+    
+    unsigned int longest = 0;
+    for (unsigned int i=0; i<inputs.size(); i++){
+      if (inputs[i]){
+        longest = std::max(longest, chainLength(inputs[i], lengths));
+      }
+    }
+    
+    lengths[node] = longest + 1;
+    return longest + 1;
+  }
+
+  // depth-first, post-order: all inputs are appended before the node itself
+  void GraphSchedule_::appendNode( Generator_ * node, std::set<Generator_*> & visited ){
+
+    if (!visited.insert(node).second) return;
+
+    // read before walking the inputs, so a change made during the walk leaves the schedule stale
+    revision_ += node->inputsRevision();
+
+    vector<Generator_*> inputs;
+    node->appendInputs(inputs);
+
+    for (unsigned int i=0; i<inputs.size(); i++){
+      if (inputs[i]){
+        appendNode(inputs[i], visited);
+      }
+    }
+
+    nodes_.push_back(Generator(node));
+  }
+
+}}
@@ -0,0 +1,96 @@
+//
+//  GraphSchedule.h
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#ifndef TONIC_GRAPHSCHEDULE_H
+#define TONIC_GRAPHSCHEDULE_H
+
+#include "Generator.h"
+#include <map>
+
+namespace Tonic {
+
+  namespace Tonic_ {
+
+    //! Flat, dependency-ordered list of the generators in a graph.
+    /*!
+        Running the schedule computes every generator once, inputs before the generators that read them,
+        so by the time a generator ticks its inputs their output is already cached and ticking doesn't recurse.
+        The schedule holds a reference to every generator in it, so nothing in it is freed while it may run.
+        Once any generator in it has its inputs replaced, added or removed (see Generator_::inputsRevision())
+        the schedule is stale: isCurrent() is false, the owner must stop running it and fall back to recursive
+        ticking until it is recompiled. Rewiring generators that aren't in the schedule doesn't affect it.
+    */
+    class GraphSchedule_ {
+
+    protected:
+
+      vector<Generator> nodes_;
+      int               revision_;      // sum of the nodes' inputsRevision() at compile time
+      unsigned int      scratchDepth_;
+
+      void appendNode( Generator_ * node, std::set<Generator_*> & visited );
+      
+      static unsigned int chainLength( Generator_ * node, std::map<Generator_*, unsigned int> & lengths );
+
+    public:
+
+      GraphSchedule_();
+
+      //! Rebuild the schedule for the graph ending at root. Allocates, so call it off the audio thread.
+      void compile( Generator_ * root );
+
+      //! Upper bound on the ScratchFrames_ any single generator holds while its inputs compute
+      static const unsigned int kScratchFramesPerNode = 8;
+      
+      //! Scratch stack capacity that covers every chain of nested borrows in the graph ending at root.
+      /*! Counts inputs that aren't scheduled too, since the graph is ticked recursively while a schedule is stale. */
+      static unsigned int scratchDepth( Generator_ * root );
+
+      //! Exchange contents with another schedule without allocating
+      void swap( GraphSchedule_ & other ){
+        nodes_.swap(other.nodes_);
+        std::swap(revision_, other.revision_);
+        std::swap(scratchDepth_, other.scratchDepth_);
+      }
+      
+      //! scratchDepth() of the graph this was compiled for
+      unsigned int scratchDepth() const { return scratchDepth_; }
+
+      //! False once any generator in the schedule had its inputs changed since the last compile
+      /*! Revisions only ever increase, so their sum changes whenever any one of them does. */
+      bool isCurrent() const {
+        int revision = 0;
+        for (unsigned int i=0; i<nodes_.size(); i++){
+          revision += nodes_[i].rawGenerator()->inputsRevision();
+        }
+        return revision == revision_;
+      }
+
+      //! Compute each generator's output for this context, in dependency order
+      void run( const SynthesisContext_ & context ){
+        for (unsigned int i=0; i<nodes_.size(); i++){
+          nodes_[i].rawGenerator()->updateOutput(context);
+        }
+      }
+
+      unsigned int size() const { return (unsigned int)nodes_.size(); }
+
+      //! Whether node has a slot in the schedule
+      bool contains( const Generator_ * node ) const {
+        for (unsigned int i=0; i<nodes_.size(); i++){
+          if (nodes_[i].rawGenerator() == node) return true;
+        }
+        return false;
+      }
+
+    };
+
+  }
+
+}
+
+#endif
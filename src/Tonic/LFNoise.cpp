@@ -16,7 +16,7 @@ namespace Tonic_{
 
 
 LFNoise_::LFNoise_() : mCounter(0){
-  mFreqFrames.resize(kSynthesisBlockSize);
+  mFreqFrames.resize(synthesisBlockSize());
 }
 
 void  LFNoise_::setFreq(ControlGenerator freq){
@@ -13,6 +13,7 @@
 #define __TonicDemo__LFNoise__
 
 #include "Generator.h"
+#include "Random.h"
 
 namespace Tonic{
 
@@ -25,6 +26,7 @@ namespace Tonic{
       float         mSlope;
       signed long   mCounter;
       float         mLevel;
+      Random        mRandom;
       
       void computeSynthesisBlock( const SynthesisContext_ &context );
       
@@ -32,6 +34,7 @@ namespace Tonic{
       
         ControlGenerator     mFreq;
         void setFreq(ControlGenerator freq);
+        void setSeed(TonicUInt32 seed){ mRandom.seed(seed); }
         LFNoise_();
     
     };
@@ -41,9 +44,9 @@ namespace Tonic{
       TonicFloat* out = &outputFrames_[0];
       do{
         if (mCounter<=0) {
-          mCounter = sampleRate() / std::max<float>(mFreq.tick(context).value, .001f);
+          mCounter = sampleRate_ / std::max<float>(mFreq.tick(context).value, .001f);
           mCounter = std::max<float>(1, mCounter);
-          float nextlevel = randomFloat(-1, 1);
+          float nextlevel = mRandom.nextFloat(-1, 1);
           mSlope = (nextlevel - mLevel) / mCounter;
         }
         unsigned long nsmps = std::min(remain, (unsigned long)mCounter);
@@ -62,6 +65,12 @@ namespace Tonic{
   class LFNoise : public TemplatedGenerator<Tonic_::LFNoise_>{
   public:
     TONIC_MAKE_CTRL_GEN_SETTERS(LFNoise, setFreq, setFreq);
+    
+    //! Restart the noise sequence from a seed
+    LFNoise & seed(TonicUInt32 seed){
+      gen()->setSeed(seed);
+      return *this;
+    }
   };
 
 }
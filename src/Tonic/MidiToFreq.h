@@ -0,0 +1,42 @@
+//
+//  MidiToFreq.h
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#ifndef TONIC_MIDITOFREQ_H
+#define TONIC_MIDITOFREQ_H
+
+#include "Effect.h"
+
+namespace Tonic {
+
+  namespace Tonic_ {
+
+    class MidiToFreq_ : public Effect_{
+
+    protected:
+
+      void computeSynthesisBlock( const SynthesisContext_ &context ){
+        vmtof(&dryInput()[0], &outputFrames_[0], outputFrames_.size());
+      }
+
+    public:
+
+      // a silent input is note 0, not silence
+      MidiToFreq_(){ setSilenceDetection(-1, 0); }
+
+    };
+
+  }
+
+  //! Audio-rate counterpart of ControlMidiToFreq: converts every sample of its input from a midi note number to Hz.
+  /*!
+      Uses the vectorized vmtof, so per-sample pitch modulation costs little more than a multiply.
+   */
+  class MidiToFreq : public TemplatedEffect<MidiToFreq, Tonic_::MidiToFreq_> {};
+
+}
+
+#endif
@@ -12,14 +12,13 @@ namespace Tonic {
   
   namespace Tonic_ { 
   
-    Mixer_::Mixer_() {
-      workSpace_.resize(kSynthesisBlockSize, 2, 0);
-    }
+    Mixer_::Mixer_() {}
     
     void Mixer_::addInput(BufferFiller input)
     {
       // no checking for duplicates, maybe we should
       inputs_.push_back(input);
+      inputsChanged();
     }
     
     void Mixer_::removeInput(BufferFiller input)
@@ -27,6 +26,7 @@ namespace Tonic {
       vector<BufferFiller>::iterator it = std::find(inputs_.begin(), inputs_.end(), input);
       if (it != inputs_.end()){
         inputs_.erase(it);
+        inputsChanged();
       }
     }
   }
@@ -26,7 +26,6 @@ namespace Tonic {
       
     private:
       
-      TonicFrames workSpace_;
       vector<BufferFiller> inputs_;
       
       void computeSynthesisBlock(const SynthesisContext_ &context);
@@ -38,18 +37,37 @@ namespace Tonic {
       void addInput(BufferFiller input);
       void removeInput(BufferFiller input);
       
+      void appendInputs( vector<Generator_*> & inputs ){
+        for (unsigned int i=0; i<inputs_.size(); i++) inputs.push_back(inputs_[i].rawGenerator());
+      };
+      
     };
     
     inline void Mixer_::computeSynthesisBlock(const SynthesisContext_ &context)
     {
-      // Clear buffer
-      outputFrames_.clear();
+      bool silent = true;
       
       // Tick and add inputs
       for (unsigned int i=0; i<inputs_.size(); i++){
         // Tick each bufferFiller every time, with our context (for now).
-        inputs_[i].tick(workSpace_, context);
-        outputFrames_ += workSpace_;
+        ScratchFrames_ workspace(context, 2);
+        const TonicFrames & frames = inputs_[i].output(context, *workspace);
+        
+        // silent inputs (e.g. idle PolySynth voices) add nothing
+        if (inputs_[i].isSilentOutput()) continue;
+        
+        if (silent){
+          outputFrames_.clear();
+          silent = false;
+        }
+        outputFrames_ += frames;
+      }
+      
+      if (silent){
+        setConstantOutput(0);
+      }
+      else{
+        isConstantOutput_ = false;
       }
       
     }
@@ -58,18 +76,34 @@ namespace Tonic {
   
   class Mixer : public TemplatedBufferFiller<Tonic_::Mixer_>{
     
+  protected:
+    
+    // Capacity of a scratch stack deep enough for the mixer reading input, or 0 if the current one is.
+    // Inputs compute with the mixer's context, so they borrow from its stack.
+    unsigned int scratchCapacityFor(BufferFiller input){
+      unsigned int depth = Tonic_::GraphSchedule_::kScratchFramesPerNode + Tonic_::GraphSchedule_::scratchDepth(input.rawGenerator());
+      return depth > gen()->scratchCapacity() ? depth : 0;
+    }
+    
   public:
     
     void addInput(BufferFiller input){
+      // allocated before taking the lock, so the audio thread isn't held up by it
+      Tonic_::ScratchStack_ scratch(scratchCapacityFor(input));
+      
       gen()->lockMutex();
       gen()->addInput(input);
+      if (scratch.capacity()) gen()->swapScratch(scratch);
       gen()->unlockMutex();
     }
     
     void addInput(BufferFiller input1, BufferFiller input2){
+      Tonic_::ScratchStack_ scratch(std::max(scratchCapacityFor(input1), scratchCapacityFor(input2)));
+      
       gen()->lockMutex();
       gen()->addInput(input1);
       gen()->addInput(input2);
+      if (scratch.capacity()) gen()->swapScratch(scratch);
       gen()->unlockMutex();
     }
     
@@ -77,6 +111,7 @@ namespace Tonic {
       gen()->lockMutex();
       gen()->removeInput(input);
       gen()->unlockMutex();
+      collectGarbage();
     }
     
   };
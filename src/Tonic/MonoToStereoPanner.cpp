@@ -14,7 +14,7 @@ namespace Tonic{
   
     MonoToStereoPanner_::MonoToStereoPanner_(){
       setIsStereoOutput(true);
-      panFrames.resize(kSynthesisBlockSize, 1);
+      panFrames.resize(synthesisBlockSize(), 1);
       setPan(ControlValue(0));
     }
     MonoToStereoPanner_::~MonoToStereoPanner_(){}
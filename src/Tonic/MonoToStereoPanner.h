@@ -38,9 +38,9 @@ namespace Tonic {
     inline void MonoToStereoPanner_::computeSynthesisBlock(const SynthesisContext_ &context){
       
       TonicFloat *synthBlockWriteHead = &outputFrames_[0];
-      TonicFloat *dryFramesReadHead = &dryFrames_[0];
+      const TonicFloat *dryFramesReadHead = &dryInput()[0];
       
-      unsigned int nSamples = kSynthesisBlockSize;
+      unsigned int nSamples = synthesisBlockSize();
       float panValue = panControlGen.tick(context).value;
       float leftVol = 1. - max(0., panValue);
       float rightVol = 1 + min(0., panValue);
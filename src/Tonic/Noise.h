@@ -13,6 +13,7 @@
 #define TONIC_NOISE_H
 
 #include "Generator.h"
+#include "Random.h"
 
 namespace Tonic {
   
@@ -22,15 +23,18 @@ namespace Tonic {
       
     protected:
       
+      Random random_;
+      
       void computeSynthesisBlock( const SynthesisContext_ & context );
       
+    public:
+      
+      void setSeed( TonicUInt32 seed ){ random_.seed(seed); }
+      
     };
     
     inline void Noise_::computeSynthesisBlock( const SynthesisContext_ & context ){
-      TonicFloat* fdata = &outputFrames_[0];
-      for (unsigned int i=0; i<outputFrames_.size(); i++){
-        *fdata++ = randomSample();
-      }
+      random_.fill(&outputFrames_[0], outputFrames_.size());
     }
     
     // Pink noise generator. Sources:
@@ -50,11 +54,15 @@ namespace Tonic {
       TonicFloat    pinkBins_[kNumPinkNoiseBins];
       unsigned long pinkCount_;
       
+      Random        random_;
+      
       void computeSynthesisBlock( const SynthesisContext_ & context);
       
     public:
       
       PinkNoise_();      
+      
+      void setSeed( TonicUInt32 seed ){ random_.seed(seed); }
 
     };
     
@@ -66,7 +74,7 @@ namespace Tonic {
       
       TonicFloat* outptr = &outputFrames_[0];
       
-      for (unsigned int i=0; i<kSynthesisBlockSize; i++){
+      for (unsigned int i=0; i<synthesisBlockSize(); i++){
         
         binidx = countTrailingZeros(pinkCount_);
         binidx = binidx & (kNumPinkNoiseBins-1);
@@ -74,7 +82,7 @@ namespace Tonic {
         prevbinval = pinkBins_[binidx];
         
         while (true){
-          binval = randomSample();
+          binval = random_.nextSample();
         
           pinkBins_[binidx] = binval;
         
@@ -90,7 +98,7 @@ namespace Tonic {
         
         pinkCount_++;
     
-        *outptr++ = (randomSample() + pinkAccum_)/(kNumPinkNoiseBinsLog2+1);
+        *outptr++ = (random_.nextSample() + pinkAccum_)/(kNumPinkNoiseBinsLog2+1);
       }
   
     }
@@ -103,14 +111,29 @@ namespace Tonic {
     }
   }
   
+  //! White noise. Each instance has its own generator; see setRandomSeed for reproducible output.
   class Noise : public TemplatedGenerator<Tonic_::Noise_>{
   public:
     Noise(bool stereo = false){
       gen()->setIsStereoOutput(stereo);
     }
+    
+    //! Restart the noise sequence from a seed
+    Noise & seed(TonicUInt32 seed){
+      gen()->setSeed(seed);
+      return *this;
+    }
   };
 
-  class PinkNoise : public TemplatedGenerator<Tonic_::PinkNoise_> {};
+  class PinkNoise : public TemplatedGenerator<Tonic_::PinkNoise_> {
+  public:
+    
+    //! Restart the noise sequence from a seed
+    PinkNoise & seed(TonicUInt32 seed){
+      gen()->setSeed(seed);
+      return *this;
+    }
+  };
 
 }
 
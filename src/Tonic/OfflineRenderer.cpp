@@ -0,0 +1,167 @@
+//
+//  OfflineRenderer.cpp
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#include "OfflineRenderer.h"
+#include <fstream>
+
+namespace Tonic {
+
+  // -- WAV file helpers --
+
+  static void writeLE( std::ofstream & out, TonicUInt32 value, unsigned int nBytes ){
+    for (unsigned int i=0; i<nBytes; i++){
+      out.put((char)((value >> (8*i)) & 0xFF));
+    }
+  }
+
+  static void writeWavHeader( std::ofstream & out, unsigned int numChannels, bool floatFormat, TonicUInt32 numSamples, TonicFloat sampleRate ){
+
+    const unsigned int bytesPerSample = floatFormat ? 4 : 2;
+    const TonicUInt32 dataBytes = numSamples * bytesPerSample;
+    const TonicUInt32 rate = (TonicUInt32)sampleRate;
+
+    out.write("RIFF", 4);
+    writeLE(out, 36 + dataBytes, 4);
+    out.write("WAVE", 4);
+
+    out.write("fmt ", 4);
+    writeLE(out, 16, 4);
+    writeLE(out, floatFormat ? 3 : 1, 2); // 3 = IEEE float, 1 = integer PCM
+    writeLE(out, numChannels, 2);
+    writeLE(out, rate, 4);
+    writeLE(out, rate * numChannels * bytesPerSample, 4);
+    writeLE(out, numChannels * bytesPerSample, 2);
+    writeLE(out, bytesPerSample * 8, 2);
+
+    out.write("data", 4);
+    writeLE(out, dataBytes, 4);
+  }
+
+  static void writeWavSamples( std::ofstream & out, const TonicFloat * samples, unsigned long numSamples, bool floatFormat ){
+
+    const unsigned int bytesPerSample = floatFormat ? 4 : 2;
+    vector<unsigned char> bytes(numSamples * bytesPerSample);
+    unsigned char * byteptr = bytes.empty() ? NULL : &bytes[0];
+
+    for (unsigned long i=0; i<numSamples; i++){
+      TonicUInt32 value;
+      if (floatFormat){
+        memcpy(&value, &samples[i], sizeof(value));
+      }
+      else{
+        value = (TonicUInt32)(TonicInt32)lrintf(clamp(samples[i], -1.f, 1.f) * 32767.f);
+      }
+      for (unsigned int b=0; b<bytesPerSample; b++){
+        *byteptr++ = (unsigned char)((value >> (8*b)) & 0xFF);
+      }
+    }
+
+    if (!bytes.empty()){
+      out.write((const char*)&bytes[0], bytes.size());
+    }
+  }
+
+  // -- OfflineRenderer --
+
+  OfflineRenderer::OfflineRenderer( BufferFiller source, unsigned int numChannels, unsigned int bufferFrames ) :
+    source_(source),
+    numChannels_(numChannels > 1 ? 2 : 1),
+    bufferFrames_(bufferFrames > 0 ? bufferFrames : 1),
+    framesRendered_(0),
+    renderSeconds_(0),
+    renderRate_(source.getSampleRate())
+  {
+    buffer_.resize(bufferFrames_ * numChannels_, 0);
+  }
+
+  void OfflineRenderer::resetStatistics(){
+    framesRendered_ = 0;
+    renderSeconds_ = 0;
+    renderRate_ = source_.getSampleRate();
+  }
+
+  void OfflineRenderer::renderChunk( unsigned int nFrames ){
+    double start = hostTimeSeconds();
+    source_.fillBufferOfFloats(&buffer_[0], nFrames, numChannels_);
+    renderSeconds_ += hostTimeSeconds() - start;
+    framesRendered_ += nFrames;
+  }
+
+  void OfflineRenderer::render( unsigned long numFrames, vector<TonicFloat> & outSamples ){
+
+    resetStatistics();
+    outSamples.resize(numFrames * numChannels_);
+
+    unsigned long framesRemaining = numFrames;
+    TonicFloat * outptr = outSamples.empty() ? NULL : &outSamples[0];
+
+    while (framesRemaining > 0){
+      unsigned int nFrames = (unsigned int)std::min<unsigned long>(framesRemaining, bufferFrames_);
+      renderChunk(nFrames);
+      memcpy(outptr, &buffer_[0], nFrames * numChannels_ * sizeof(TonicFloat));
+      outptr += nFrames * numChannels_;
+      framesRemaining -= nFrames;
+    }
+  }
+
+  vector<TonicFloat> OfflineRenderer::render( float seconds ){
+    vector<TonicFloat> samples;
+    render((unsigned long)(max(0, seconds) * source_.getSampleRate()), samples);
+    return samples;
+  }
+
+  bool OfflineRenderer::renderToWavFile( string path, float seconds, bool floatFormat ){
+
+    std::ofstream out(path.c_str(), std::ios::out | std::ios::binary);
+    if (!out.is_open()){
+      error("OfflineRenderer: could not open " + path + " for writing");
+      return false;
+    }
+
+    resetStatistics();
+
+    unsigned long numFrames = (unsigned long)(max(0, seconds) * renderRate_);
+    writeWavHeader(out, numChannels_, floatFormat, (TonicUInt32)(numFrames * numChannels_), renderRate_);
+
+    unsigned long framesRemaining = numFrames;
+    while (framesRemaining > 0){
+      unsigned int nFrames = (unsigned int)std::min<unsigned long>(framesRemaining, bufferFrames_);
+      renderChunk(nFrames);
+      writeWavSamples(out, &buffer_[0], nFrames * numChannels_, floatFormat);
+      framesRemaining -= nFrames;
+    }
+
+    out.close();
+    if (out.fail()){
+      error("OfflineRenderer: error writing " + path);
+      return false;
+    }
+    return true;
+  }
+
+  bool OfflineRenderer::writeWavFile( string path, const vector<TonicFloat> & samples, unsigned int numChannels, bool floatFormat, TonicFloat rate ){
+
+    std::ofstream out(path.c_str(), std::ios::out | std::ios::binary);
+    if (!out.is_open()){
+      error("OfflineRenderer: could not open " + path + " for writing");
+      return false;
+    }
+
+    writeWavHeader(out, numChannels, floatFormat, (TonicUInt32)samples.size(), rate);
+    if (!samples.empty()){
+      writeWavSamples(out, &samples[0], samples.size(), floatFormat);
+    }
+
+    out.close();
+    if (out.fail()){
+      error("OfflineRenderer: error writing " + path);
+      return false;
+    }
+    return true;
+  }
+
+}
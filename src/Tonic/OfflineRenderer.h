@@ -0,0 +1,84 @@
+//
+//  OfflineRenderer.h
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#ifndef TONIC_OFFLINERENDERER_H
+#define TONIC_OFFLINERENDERER_H
+
+#include "BufferFiller.h"
+
+namespace Tonic {
+
+  //! Renders a BufferFiller (Synth, Mixer, etc) without an audio device, as fast as the CPU allows.
+  /*!
+      Drives fillBufferOfFloats in a tight loop, so the graph is processed exactly as it would be
+      from an audio callback of bufferFrames frames. Useful for batch rendering and performance checks.
+
+      Renders at the source's own sample rate (BufferFiller::setSampleRate), so an offline engine
+      can run at a different rate than a live one in the same process.
+
+      Usage:
+
+      Synth synth;
+      synth.setOutputGen( SineWave().freq(440) );
+
+      OfflineRenderer renderer(synth);
+      renderer.renderToWavFile("sine.wav", 10.0f);
+      printf("%.1fx realtime\n", renderer.realtimeFactor());
+  */
+  class OfflineRenderer {
+
+  protected:
+
+    BufferFiller        source_;
+    unsigned int        numChannels_;
+    unsigned int        bufferFrames_;
+    vector<TonicFloat>  buffer_;
+
+    unsigned long       framesRendered_;
+    double              renderSeconds_;
+    TonicFloat          renderRate_;
+
+    // render up to bufferFrames_ frames into buffer_, timing only the synthesis
+    void renderChunk( unsigned int nFrames );
+    void resetStatistics();
+
+  public:
+
+    OfflineRenderer( BufferFiller source, unsigned int numChannels = 2, unsigned int bufferFrames = 512 );
+
+    //! Render numFrames of interleaved audio into memory.
+    void render( unsigned long numFrames, vector<TonicFloat> & outSamples );
+
+    //! Render a duration in seconds into memory.
+    vector<TonicFloat> render( float seconds );
+
+    //! Render a duration in seconds directly to a WAV file on disk, without holding the result in memory.
+    /*!
+        Files are written as 32-bit float by default, or 16-bit integer PCM if floatFormat is false.
+        Returns false if the file could not be written.
+    */
+    bool renderToWavFile( string path, float seconds, bool floatFormat = true );
+
+    //! Write already-rendered interleaved samples to a WAV file.
+    static bool writeWavFile( string path, const vector<TonicFloat> & samples, unsigned int numChannels, bool floatFormat = true, TonicFloat rate = Tonic::sampleRate() );
+
+    // -- Statistics for the most recent render --
+
+    //! Seconds of audio produced by the last render
+    double renderedDuration() const { return (double)framesRendered_ / renderRate_; }
+
+    //! Wall-clock seconds spent synthesizing during the last render (file I/O excluded)
+    double renderTime() const { return renderSeconds_; }
+
+    //! Seconds of audio rendered per wall-clock second. Greater than 1 means faster than real time.
+    double realtimeFactor() const { return renderSeconds_ > 0 ? renderedDuration() / renderSeconds_ : 0; }
+
+  };
+
+}
+
+#endif
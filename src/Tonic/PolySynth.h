@@ -23,6 +23,7 @@ public:
     {
         allocator.addVoice(synth);
         mixer.addInput(synth);
+        updateSchedule();
     }
 
     typedef Synth (VoiceCreateFn)();
@@ -0,0 +1,190 @@
+//
+//  Profiler.cpp
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#include "Profiler.h"
+#include "Generator.h"
+#include <sstream>
+#include <iomanip>
+
+#if defined(__GNUC__) || defined(__clang__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+namespace Tonic {
+
+  static void appendProfileLines( const ProfileNode & node, double total, unsigned int depth, std::ostringstream & out ){
+
+    out << std::left << std::setw(40) << (string(depth * 2, ' ') + node.name)
+        << std::right << std::setw(10) << node.calls
+        << std::setw(14) << node.inclusiveTime * 1e3
+        << std::setw(14) << node.exclusiveTime * 1e3
+        << std::setw(9) << (total > 0 ? 100.0 * node.inclusiveTime / total : 0)
+        << std::setw(9) << (total > 0 ? 100.0 * node.exclusiveTime / total : 0)
+        << "\n";
+
+    for (unsigned int i=0; i<node.children.size(); i++){
+      appendProfileLines(node.children[i], total, depth + 1, out);
+    }
+  }
+
+  string ProfileNode::toString() const {
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << std::left << std::setw(40) << "node"
+        << std::right << std::setw(10) << "calls"
+        << std::setw(14) << "incl (ms)"
+        << std::setw(14) << "excl (ms)"
+        << std::setw(9) << "incl %"
+        << std::setw(9) << "excl %"
+        << "\n";
+
+    // unnamed root only groups the top-level nodes
+    if (name.empty()){
+      double total = 0;
+      for (unsigned int i=0; i<children.size(); i++){
+        total += children[i].inclusiveTime;
+      }
+      for (unsigned int i=0; i<children.size(); i++){
+        appendProfileLines(children[i], total, 0, out);
+      }
+    }
+    else{
+      appendProfileLines(*this, inclusiveTime, 0, out);
+    }
+
+    return out.str();
+  }
+
+  namespace Tonic_ {
+
+    string demangledTypeName( const std::type_info & type ){
+
+      string name = type.name();
+
+#if defined(__GNUC__) || defined(__clang__)
+      int status = 0;
+      char * demangled = abi::__cxa_demangle(name.c_str(), NULL, NULL, &status);
+      if (status == 0 && demangled){
+        name = demangled;
+      }
+      free(demangled);
+#endif
+
+      // strip namespaces (and MSVC's "class " prefix) and the trailing underscore of DSP-level classes
+      size_t pos = name.rfind("::");
+      if (pos != string::npos){
+        name = name.substr(pos + 2);
+      }
+      if (name.compare(0, 6, "class ") == 0){
+        name = name.substr(6);
+      }
+      if (!name.empty() && name[name.size()-1] == '_'){
+        name.erase(name.size()-1);
+      }
+
+      return name;
+    }
+
+    int newNodeId(){
+      static TONIC_ATOMIC_INT_T lastNodeId = 0;
+      return TONIC_ATOMIC_INCREMENT(lastNodeId);
+    }
+
+    Profiler_::Profiler_() : untrackedDepth_(0) {}
+
+    void Profiler_::reserve( unsigned int capacity ){
+
+      records_.clear();
+      records_.reserve(capacity);
+      stack_.clear();
+      stack_.reserve(kMaxDepth);
+
+      unsigned int slots = 1;
+      while (slots < 2 * records_.capacity()){
+        slots <<= 1;
+      }
+      slots_.assign(slots, -1);
+      untrackedDepth_ = 0;
+    }
+
+    void Profiler_::reset(){
+      std::fill(slots_.begin(), slots_.end(), -1);
+      records_.clear();
+      stack_.clear();
+      untrackedDepth_ = 0;
+    }
+
+    void Profiler_::prepare( Generator_ * root ){
+      std::set<Generator_*> visited;
+      if (root && hasStorage()){
+        prepareNode(root, -1, visited);
+      }
+    }
+
+    void Profiler_::prepareNode( Generator_ * node, int parent, std::set<Generator_*> & visited ){
+
+      if (!visited.insert(node).second) return;
+
+      unsigned int slot = findSlot(node->nodeId());
+      int record = slots_[slot] >= 0 ? slots_[slot] : addRecord(slot, node->nodeId(), typeid(*node), parent);
+      if (record < 0) return;
+
+      vector<Generator_*> inputs;
+      node->appendInputs(inputs);
+      node->appendUnscheduledInputs(inputs);
+
+      for (unsigned int i=0; i<inputs.size(); i++){
+        if (inputs[i]){
+          prepareNode(inputs[i], record, visited);
+        }
+      }
+    }
+
+    // Prepared generators that never computed are left out, unless something under them did
+    ProfileNode Profiler_::buildNode( unsigned int record ) const {
+
+      const Record & r = records_[record];
+
+      ProfileNode node;
+      node.name = demangledTypeName(*r.type);
+      node.calls = r.calls;
+      node.inclusiveTime = r.exclusiveTime;
+      node.exclusiveTime = r.exclusiveTime;
+
+      for (int child = r.firstChild; child >= 0; child = records_[child].nextSibling){
+        ProfileNode childNode = buildNode(child);
+        if (childNode.calls > 0 || !childNode.children.empty()){
+          node.inclusiveTime += childNode.inclusiveTime;
+          node.children.push_back(childNode);
+        }
+      }
+
+      return node;
+    }
+
+    ProfileNode Profiler_::report() const {
+
+      ProfileNode root;
+
+      for (unsigned int i=0; i<records_.size(); i++){
+        if (records_[i].parent < 0){
+          ProfileNode child = buildNode(i);
+          if (child.calls == 0 && child.children.empty()) continue;
+          root.calls = std::max(root.calls, child.calls);
+          root.inclusiveTime += child.inclusiveTime;
+          root.children.push_back(child);
+        }
+      }
+
+      return root;
+    }
+
+  }
+
+}
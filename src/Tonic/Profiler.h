@@ -0,0 +1,231 @@
+//
+//  Profiler.h
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#ifndef TONIC_PROFILER_H
+#define TONIC_PROFILER_H
+
+#include "TonicCore.h"
+#include <typeinfo>
+
+namespace Tonic {
+
+  //! One node of a hierarchical CPU cost report, as returned by Synth::getProfile()
+  /*!
+      Times are wall-clock seconds accumulated since profiling was enabled or last reset.
+      Inclusive time is the node's exclusive time plus the inclusive time of its children, whether the
+      graph ran recursively or from its compiled schedule. A generator whose output is shared by several
+      consumers appears under the first of them in graph order; a control generator under the first
+      node that ticked it.
+  */
+  struct ProfileNode {
+
+    string          name;
+    unsigned long   calls;
+    double          inclusiveTime;
+    double          exclusiveTime;
+    vector<ProfileNode> children;
+
+    ProfileNode() : calls(0), inclusiveTime(0), exclusiveTime(0) {}
+
+    //! Indented, human-readable table of the report
+    string toString() const;
+
+  };
+
+  namespace Tonic_ {
+
+    class Generator_;
+
+    //! Readable class name for a node, without namespaces or trailing underscore
+    string demangledTypeName( const std::type_info & type );
+
+    //! Unique id for a new node. Profiles key their records by it, since a freed node's address can be reused.
+    int newNodeId();
+
+    //! Records time spent computing each Generator_ / ControlGenerator_ during ticks.
+    /*!
+        Owned by a BufferFiller_ and passed down the graph through SynthesisContext_::profiler.
+        Only touched from the audio thread while profiling is enabled. Storage for the records is
+        reserved up front, so measuring never allocates. Nodes beyond the reserved capacity, and
+        anything they compute, are counted in the exclusive time of the node that computed them.
+    */
+    class Profiler_ {
+
+    protected:
+
+      struct Record {
+        const std::type_info * type;
+        int           node;
+        int           parent;
+        int           firstChild;
+        int           lastChild;
+        int           nextSibling;
+        unsigned long calls;
+        double        exclusiveTime;
+      };
+
+      struct StackFrame {
+        unsigned int  record;
+        double        startTime;
+        double        childTime;
+      };
+
+      // open-addressed table of record indices keyed by node id, -1 where empty. Never more than half full.
+      vector<int>         slots_;
+      vector<Record>      records_;
+      vector<StackFrame>  stack_;
+
+      // scopes opened while the records or the stack were full, which aren't timed
+      unsigned int        untrackedDepth_;
+
+      // slot holding node's record, or the empty slot where it belongs
+      unsigned int findSlot( int node ) const {
+        const unsigned int mask = (unsigned int)slots_.size() - 1;
+        unsigned int slot = ((unsigned int)node * 2654435761u) & mask;
+        while (slots_[slot] >= 0 && records_[slots_[slot]].node != node){
+          slot = (slot + 1) & mask;
+        }
+        return slot;
+      }
+
+      // new record in the empty slot for node, or -1 if the records are full
+      int addRecord( unsigned int slot, int node, const std::type_info & type, int parent );
+
+      void prepareNode( Generator_ * node, int parent, std::set<Generator_*> & visited );
+
+      ProfileNode buildNode( unsigned int record ) const;
+
+    public:
+
+      Profiler_();
+
+      //! Number of nodes and nesting levels storage is reserved for when profiling is enabled
+      static const unsigned int kDefaultCapacity = 4096;
+      static const unsigned int kMaxDepth = 256;
+
+      //! Reserve storage for capacity nodes and discard all measurements. Allocates, so call it off the audio thread.
+      void reserve( unsigned int capacity );
+
+      bool hasStorage() const { return !slots_.empty(); }
+
+      //! Create records for every generator in the graph ending at root, each under its first consumer.
+      /*!
+          Without these, generators first seen while a compiled schedule runs would have no consumer on
+          the stack and appear at the top level. Allocates, so call it off the audio thread.
+      */
+      void prepare( Generator_ * root );
+
+      void beginNode( int node, const std::type_info & type );
+      void endNode();
+
+      //! Discard all measurements. Should be called after the graph is changed.
+      void reset();
+
+      //! Hierarchical report. Root node is unnamed and collects all top-level nodes as children.
+      ProfileNode report() const;
+
+    };
+
+    inline void Profiler_::beginNode( int node, const std::type_info & type ){
+
+      if (untrackedDepth_ || stack_.size() == stack_.capacity()){
+        untrackedDepth_++;
+        return;
+      }
+
+      const unsigned int slot = findSlot(node);
+      int record = slots_[slot];
+
+      if (record < 0){
+        // first time this node is seen - parent is whoever is ticking it right now
+        record = addRecord(slot, node, type, stack_.empty() ? -1 : (int)stack_.back().record);
+        if (record < 0){
+          untrackedDepth_++;
+          return;
+        }
+      }
+
+      StackFrame frame;
+      frame.record = (unsigned int)record;
+      frame.childTime = 0;
+      frame.startTime = hostTimeSeconds();
+      stack_.push_back(frame);
+    }
+
+    inline int Profiler_::addRecord( unsigned int slot, int node, const std::type_info & type, int parent ){
+
+      if (records_.size() == records_.capacity()) return -1;
+
+      Record r;
+      r.type = &type;
+      r.node = node;
+      r.parent = parent;
+      r.firstChild = -1;
+      r.lastChild = -1;
+      r.nextSibling = -1;
+      r.calls = 0;
+      r.exclusiveTime = 0;
+
+      int record = (int)records_.size();
+      records_.push_back(r);
+      if (parent >= 0){
+        Record & p = records_[parent];
+        if (p.lastChild >= 0){
+          records_[p.lastChild].nextSibling = record;
+        }
+        else{
+          p.firstChild = record;
+        }
+        p.lastChild = record;
+      }
+      slots_[slot] = record;
+      return record;
+    }
+
+    inline void Profiler_::endNode(){
+
+      if (untrackedDepth_){
+        untrackedDepth_--;
+        return;
+      }
+
+      double now = hostTimeSeconds();
+      StackFrame frame = stack_.back();
+      stack_.pop_back();
+
+      double elapsed = now - frame.startTime;
+      Record & r = records_[frame.record];
+      r.calls++;
+      r.exclusiveTime += elapsed - frame.childTime;
+
+      if (!stack_.empty()){
+        stack_.back().childTime += elapsed;
+      }
+    }
+
+    //! Times the enclosing scope as the computation of one node, if profiling is enabled.
+    class ProfilerScope_ {
+
+      Profiler_ * profiler_;
+
+    public:
+
+      ProfilerScope_( Profiler_ * profiler, int node, const std::type_info & type ) : profiler_(profiler) {
+        if (profiler_) profiler_->beginNode(node, type);
+      }
+
+      ~ProfilerScope_(){
+        if (profiler_) profiler_->endNode();
+      }
+
+    };
+
+  }
+
+}
+
+#endif
@@ -48,6 +48,8 @@ namespace Tonic {
       void updateValue( TonicFloat value);
       void updateTarget( TonicFloat target, unsigned long lengthSamp );
       bool isFinished();
+      
+      bool canBecomeSilent(){ return true; };
   
     };
     
@@ -63,12 +65,12 @@ namespace Tonic {
       ControlGeneratorOutput lengthOutput = lengthGen_.tick(context);
       ControlGeneratorOutput targetOutput = targetGen_.tick(context);
       if (lengthOutput.triggered || targetOutput.triggered){
-        unsigned long lSamp = lengthOutput.value*Tonic::sampleRate();
+        unsigned long lSamp = lengthOutput.value*sampleRate_;
         updateTarget(targetOutput.value, lSamp);
       }
       
       TonicFloat *fdata = &outputFrames_[0];
-      unsigned int nFrames = kSynthesisBlockSize;
+      unsigned int nFrames = synthesisBlockSize();
       unsigned int stride = outputFrames_.channels();
       
       // edge case
@@ -77,28 +79,20 @@ namespace Tonic {
       }
             
       if (finished_){
-        #ifdef USE_APPLE_ACCELERATE
-        vDSP_vfill(&last_, fdata, stride, nFrames);
-        #else
-        for (unsigned int i=0; i<nFrames; i++){
-          *fdata = last_;
-          fdata += stride;
-        }
-        #endif
+        setConstantOutput(last_);
       }
       else{
         
+        isConstantOutput_ = false;
+        
         // figure out if we will finish the ramp in this tick
         unsigned long remainder = count_ > len_ ? 0 : len_ - count_;
         
         if (remainder < nFrames){
           
-          // fill part of the ramp - no need to check if remainder is 1 when using vramp
+          // fill part of the ramp, then hold the target
           // uses algorithm out[n] = start + n * increment;
-          #ifdef USE_APPLE_ACCELERATE
-          // starting point
-          last_ += inc_;
-          vDSP_vramp(&last_, &inc_, fdata, stride, remainder);
+          vramp(last_ + inc_, inc_, fdata, stride, remainder);
           
             #ifdef TONIC_DEBUG
             if(*fdata != *fdata){
@@ -106,22 +100,7 @@ namespace Tonic {
             }
             #endif
           
-          #else
-          for (unsigned int i=0; i<remainder; i++){
-            last_ += inc_;
-            *fdata = last_;
-            fdata += stride;
-          }
-          #endif
-        
-          #ifdef USE_APPLE_ACCELERATE
-          vDSP_vfill(&target_, fdata + remainder, stride, nFrames - remainder);
-          #else
-          for (unsigned int i=remainder; i<nFrames; i++){
-            *fdata = target_;
-            fdata += stride;
-          }
-          #endif
+          vfill(target_, fdata + remainder * stride, stride, nFrames - remainder);
 
           count_ = len_;
           last_ = target_;
@@ -130,23 +109,7 @@ namespace Tonic {
         else{
           
           // fill the whole ramp
-          #ifdef USE_APPLE_ACCELERATE
-          last_ += inc_;
-          vDSP_vramp(&last_, &inc_, fdata, stride, nFrames);
-          
-            #ifdef TONIC_DEBUG
-            if(*fdata != *fdata){
-              Tonic::error("RampedValue_::computeSynthesisBlock NaN detected.\n");
-            }
-            #endif
-          
-          #else
-          for (unsigned int i=0; i<nFrames; i++){
-            last_ += inc_;
-            *fdata = last_;
-            fdata += stride;
-          }
-          #endif
+          vramp(last_ + inc_, inc_, fdata, stride, nFrames);
           
           count_ += nFrames;
           last_ = outputFrames_(nFrames - 1, 0);
@@ -0,0 +1,62 @@
+//
+//  Random.cpp
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#include "Random.h"
+
+namespace Tonic {
+
+  namespace Tonic_ {
+
+    static TonicUInt32 randomSeedBase_ = 0;
+    static TONIC_ATOMIC_INT_T randomSeedCount_ = 0;
+
+    TonicUInt32 nextRandomSeed(){
+      return randomSeedBase_ + (TonicUInt32)TONIC_ATOMIC_INCREMENT(randomSeedCount_);
+    }
+
+    void seedRandomState( TonicUInt32 seed, TonicUInt32 * state, unsigned int nWords ){
+      // splitmix64 turns consecutive seeds into unrelated states, and never yields an all-zero lane in practice
+      uint64_t x = seed;
+      for (unsigned int i=0; i<nWords; i += 2){
+        x += 0x9E3779B97F4A7C15ull;
+        uint64_t z = x;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+        state[i] = (TonicUInt32)z;
+        if (i + 1 < nWords) state[i + 1] = (TonicUInt32)(z >> 32);
+      }
+    }
+
+    // One single-lane generator per thread for randomSample() and randomFloat(), seeded on first use
+    static TONIC_THREAD_LOCAL TonicUInt32 threadRandomState_[4];
+    static TONIC_THREAD_LOCAL bool threadRandomSeeded_ = false;
+
+    static TonicUInt32 threadRandomBits(){
+      if (!threadRandomSeeded_){
+        seedRandomState(nextRandomSeed(), threadRandomState_, 4);
+        threadRandomSeeded_ = true;
+      }
+      return xoshiro128Plus(threadRandomState_[0], threadRandomState_[1], threadRandomState_[2], threadRandomState_[3]);
+    }
+
+  }
+
+  void setRandomSeed( TonicUInt32 seed ){
+    Tonic_::randomSeedBase_ = seed;
+    Tonic_::randomSeedCount_ = 0;
+  }
+
+  TonicFloat randomSample(){
+    return Tonic_::randomBitsToSample(Tonic_::threadRandomBits());
+  }
+
+  float randomFloat(float a, float b){
+    return a + (float)(Tonic_::threadRandomBits() >> 8) * (1.f / 16777216.f) * (b - a);
+  }
+
+}
@@ -0,0 +1,94 @@
+//
+//  Random.h
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#ifndef TONIC_RANDOM_H
+#define TONIC_RANDOM_H
+
+#include "VectorMath.h"
+
+namespace Tonic {
+
+  //! Seed the sequence that generators get their default seeds from.
+  /*!
+      Every Random created without an explicit seed takes the next seed from a global sequence, so
+      calling setRandomSeed before building a graph makes all of its noise reproducible, as long as
+      the graph is built in the same order.
+   */
+  void setRandomSeed( TonicUInt32 seed );
+
+  namespace Tonic_ {
+
+    //! Next default seed from the sequence started by setRandomSeed. Thread-safe.
+    TonicUInt32 nextRandomSeed();
+
+    //! One xoshiro128+ step on one lane's state words. Returns 32 random bits; the high bits are the best.
+    inline TonicUInt32 xoshiro128Plus( TonicUInt32 & s0, TonicUInt32 & s1, TonicUInt32 & s2, TonicUInt32 & s3 ){
+      const TonicUInt32 result = s0 + s3;
+      const TonicUInt32 t = s1 << 9;
+      s2 ^= s0;
+      s3 ^= s1;
+      s1 ^= s2;
+      s0 ^= s3;
+      s2 ^= t;
+      s3 = (s3 << 11) | (s3 >> 21);
+      return result;
+    }
+
+    //! Uniform sample in [-1, 1) from the top 24 of 32 random bits
+    inline TonicFloat randomBitsToSample( TonicUInt32 bits ){
+      return (TonicFloat)(bits >> 8) * (1.f / 8388608.f) - 1.f;
+    }
+
+    //! Fill a xoshiro128+ state of any size from a seed, with splitmix64 as recommended by its authors
+    void seedRandomState( TonicUInt32 seed, TonicUInt32 * state, unsigned int nWords );
+
+  }
+
+  //! Fast, seedable pseudo-random number generator, meant to be owned by a single node.
+  /*!
+      Runs TONIC_RANDOM_LANES independent xoshiro128+ generators side by side, so fill() can produce
+      a block of samples in vector registers. Given the same seed (and block size) the output is
+      the same on every platform and SimdLevel. Not thread-safe: each node or thread needs its own.
+   */
+  class Random {
+
+    TonicUInt32 state_[TONIC_RANDOM_STATE_WORDS];
+
+  public:
+
+    //! Seeded with the next seed from the setRandomSeed sequence
+    Random() { seed(Tonic_::nextRandomSeed()); }
+
+    explicit Random( TonicUInt32 seed ) { this->seed(seed); }
+
+    void seed( TonicUInt32 seed ) { Tonic_::seedRandomState(seed, state_, TONIC_RANDOM_STATE_WORDS); }
+
+    //! 32 random bits, from the first lane
+    TonicUInt32 nextBits(){
+      return Tonic_::xoshiro128Plus(state_[0], state_[TONIC_RANDOM_LANES], state_[2 * TONIC_RANDOM_LANES], state_[3 * TONIC_RANDOM_LANES]);
+    }
+
+    //! Uniform sample in [-1, 1)
+    TonicFloat nextSample(){
+      return Tonic_::randomBitsToSample(nextBits());
+    }
+
+    //! Uniform float in [a, b)
+    TonicFloat nextFloat( TonicFloat a, TonicFloat b ){
+      return a + (TonicFloat)(nextBits() >> 8) * (1.f / 16777216.f) * (b - a);
+    }
+
+    //! Fill out with uniform samples in [-1, 1), several at a time
+    void fill( TonicFloat * out, unsigned int length ){
+      vnoise(state_, out, length);
+    }
+
+  };
+
+}
+
+#endif
@@ -12,8 +12,6 @@ namespace Tonic { namespace Tonic_{
   
   RectWave_::RectWave_() : phaseAccum_(0) {
     pwmGen_ = FixedValue(0.5);
-    freqFrames_.resize(kSynthesisBlockSize, 1 ,0);
-    pwmFrames_.resize(kSynthesisBlockSize, 1, 0);
   }
   
   // ------
@@ -21,7 +19,6 @@ namespace Tonic { namespace Tonic_{
   RectWaveBL_::RectWaveBL_()
   {
     pwmGen_ = FixedValue(0.5);
-    pwmFrames_.resize(kSynthesisBlockSize, 1, 0);
   }
   
 } // Namespace Tonic_
@@ -30,9 +30,6 @@ namespace Tonic {
         Generator freqGen_;
         Generator pwmGen_;
         
-        TonicFrames freqFrames_;
-        TonicFrames pwmFrames_;
-        
         double phaseAccum_;
       
         void computeSynthesisBlock( const SynthesisContext_ &context );
@@ -41,12 +38,19 @@ namespace Tonic {
       
         RectWave_();
         
+        void appendInputs( vector<Generator_*> & inputs ){
+          inputs.push_back(freqGen_.rawGenerator());
+          inputs.push_back(pwmGen_.rawGenerator());
+        };
+
         void setFrequencyGenerator( Generator gen ){
           freqGen_ = gen;
+          inputsChanged();
         }
         
         void setPwmGenerator( Generator gen ){
           pwmGen_ = gen;
+          inputsChanged();
         }
         
         
@@ -55,26 +59,21 @@ namespace Tonic {
     inline void RectWave_::computeSynthesisBlock(const SynthesisContext_ &context){
       
       // tick freq and pwm
-      freqGen_.tick(freqFrames_, context);
-      pwmGen_.tick(pwmFrames_, context);
+      ScratchFrames_ freqFrames(context, 1);
+      freqGen_.tick(*freqFrames, context);
+      ScratchFrames_ pwmFrames(context, 1);
+      pwmGen_.tick(*pwmFrames, context);
       
-      const TonicFloat rateConstant =  TONIC_RECT_RES / Tonic::sampleRate();
+      const TonicFloat rateConstant =  TONIC_RECT_RES / sampleRate_;
 
       TonicFloat *outptr = &outputFrames_[0];
-      TonicFloat *freqptr = &freqFrames_[0];
-      TonicFloat *pwmptr = &pwmFrames_[0];
+      TonicFloat *freqptr = &(*freqFrames)[0];
+      TonicFloat *pwmptr = &(*pwmFrames)[0];
       
       FastPhasor sd;
       
       // pre-multiply rate constant for speed
-#ifdef USE_APPLE_ACCELERATE
-      vDSP_vsmul(freqptr, 1, &rateConstant, freqptr, 1, kSynthesisBlockSize);
-#else
-      for (unsigned int i=0; i<kSynthesisBlockSize; i++){
-        *freqptr++ *= rateConstant;
-      }
-      freqptr = &freqFrames_[0];
-#endif
+      vsmul(freqptr, 1, rateConstant, freqptr, 1, synthesisBlockSize());
       
       sd.d = BIT32DECPT;
       TonicInt32 offs, msbi = sd.i[1];
@@ -109,42 +108,41 @@ namespace Tonic {
       
       // Input Generators
       Generator   pwmGen_;
-      TonicFrames pwmFrames_;
           
       void computeSynthesisBlock( const SynthesisContext_ &context );
       
     public:
       
       RectWaveBL_();
-      void setPWMGen(Generator gen) { pwmGen_ = gen; };
+      void setPWMGen(Generator gen) { pwmGen_ = gen; inputsChanged(); };
+
+      void appendInputs( vector<Generator_*> & inputs ){
+        BLEPOscillator_::appendInputs(inputs);
+        inputs.push_back(pwmGen_.rawGenerator());
+      };
 
     };
     
     inline void RectWaveBL_::computeSynthesisBlock(const Tonic_::SynthesisContext_ &context)
     {
       
-      static const TonicFloat rateConstant =  1.0f / Tonic::sampleRate();
+      const TonicFloat rateConstant =  1.0f / sampleRate_;
       
       // tick freq and pwm
-      freqGen_.tick(freqFrames_, context);
-      pwmGen_.tick(pwmFrames_, context);
+      ScratchFrames_ freqFrames(context, 1);
+      freqGen_.tick(*freqFrames, context);
+      ScratchFrames_ pwmFrames(context, 1);
+      pwmGen_.tick(*pwmFrames, context);
       
       TonicFloat *outptr = &outputFrames_[0];
-      TonicFloat *freqptr = &freqFrames_[0];
-      TonicFloat *pwmptr = &pwmFrames_[0];
+      TonicFloat *freqptr = &(*freqFrames)[0];
+      TonicFloat *pwmptr = &(*pwmFrames)[0];
             
       // pre-multiply rate constant for speed
-#ifdef USE_APPLE_ACCELERATE
-      vDSP_vsmul(freqptr, 1, &rateConstant, freqptr, 1, kSynthesisBlockSize);
-#else
-      for (unsigned int i=0; i<kSynthesisBlockSize; i++){
-        *freqptr++ *= rateConstant;
-      }
-      freqptr = &freqFrames_[0];
-#endif
+      vsmul(freqptr, 1, rateConstant, freqptr, 1, synthesisBlockSize());
             
       // TODO: Maybe do this using a fast phasor for wraparound speed
-      for (unsigned int i=0; i<kSynthesisBlockSize; i++, pwmptr++, freqptr++, outptr++){
+      for (unsigned int i=0; i<synthesisBlockSize(); i++, pwmptr++, freqptr++, outptr++){
         
         phase_ += *freqptr;
         
@@ -50,25 +50,29 @@ namespace Tonic { namespace Tonic_{
     delayForward_.setInterpolates(false);
   }
   
+  void ImpulseDiffuserAllpass::setSampleRate(TonicFloat sampleRate)
+  {
+    delayBack_.setSampleRate(sampleRate);
+    delayForward_.setSampleRate(sampleRate);
+  }
+  
   // ==============
   
   // Changing these will change the character of the late-stage reverb.
   static const TonicFloat combTimeScales_[TONIC_REVERB_N_COMBS] = {1.17, 1.12, 1.02, 0.97, 0.95, 0.88, 0.84, 0.82};
   static const TonicFloat allpassTimes_[TONIC_REVERB_N_ALLPASS] = {0.0051, 0.010, 0.012, 0.00833};
   
-  Reverb_::Reverb_(){
+  Reverb_::Reverb_() : reseeded_(false) {
     
     setIsStereoOutput(true);
     
+    // longest path: pre-delay and reflection lines, then combs and allpasses
+    setSilenceDetection(0.25f, silenceThreshold_);
+    
     // Default to 50% wet
     setDryLevelGen(FixedValue(0.5f));
     setWetLevelGen(FixedValue(0.5f));
     
-    workspaceFrames_[0].resize(kSynthesisBlockSize, 1, 0);
-    workspaceFrames_[1].resize(kSynthesisBlockSize, 1, 0);
-    preOutputFrames_[0].resize(kSynthesisBlockSize, 1, 0);
-    preOutputFrames_[1].resize(kSynthesisBlockSize, 1, 0);
-    
     preDelayLine_.initialize(0.1f, 1);
     reflectDelayLine_.initialize(0.1f, 1);
     
@@ -121,9 +125,11 @@ namespace Tonic { namespace Tonic_{
     
     if (densityOutput.triggered ||
         shapeOutput.triggered ||
-        sizeOutput.triggered)
+        sizeOutput.triggered ||
+        reseeded_)
     {
       
+      reseeded_ = false;
       reflectTapTimes_.clear();
       reflectTapScale_.clear();
       
@@ -138,7 +144,7 @@ namespace Tonic { namespace Tonic_{
       TonicFloat tapScale = 1.0f/max(2.f, sqrtf(nTaps));
       for (unsigned int i=0; i<nTaps; i++){
         
-        TonicFloat dist = (i % 2 == 0 ? wDist1 : wDist2) * (1.0f + randomFloat(-TONIC_REVERB_FUDGE_AMT, TONIC_REVERB_FUDGE_AMT));
+        TonicFloat dist = (i % 2 == 0 ? wDist1 : wDist2) * (1.0f + random_.nextFloat(-TONIC_REVERB_FUDGE_AMT, TONIC_REVERB_FUDGE_AMT));
         
         reflectTapTimes_.push_back( dist/TONIC_REVERB_SOS );
         reflectTapScale_.push_back( dBToLin(dist * TONIC_REVERB_AIRDECAY)*tapScale );
@@ -167,6 +173,17 @@ namespace Tonic { namespace Tonic_{
     
   }
   
+  void Reverb_::sampleRateChanged()
+  {
+    // comb filters and input filters are generators and pick up the rate themselves
+    preDelayLine_.setSampleRate(sampleRate_);
+    reflectDelayLine_.setSampleRate(sampleRate_);
+    for (unsigned int i=0; i<TONIC_REVERB_N_ALLPASS; i++){
+      allpassFilters_[TONIC_LEFT][i].setSampleRate(sampleRate_);
+      allpassFilters_[TONIC_RIGHT][i].setSampleRate(sampleRate_);
+    }
+  }
+  
   void Reverb_::setDecayLPFCtrlGen( ControlGenerator gen )
   {
     for (unsigned int i=0; i<TONIC_REVERB_N_COMBS; i++){
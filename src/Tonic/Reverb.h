@@ -17,6 +17,7 @@
 #include "CombFilter.h"
 #include "Filters.h"
 #include "MonoToStereoPanner.h"
+#include "Random.h"
 
 
 namespace Tonic {
@@ -41,6 +42,7 @@ namespace Tonic {
       ImpulseDiffuserAllpass(TonicFloat delay, TonicFloat coef);
       ImpulseDiffuserAllpass( const ImpulseDiffuserAllpass & other);
       void tickThrough(TonicFrames & frames);
+      void setSampleRate(TonicFloat sampleRate);
       
     };
     
@@ -48,7 +50,7 @@ namespace Tonic {
     {
       TonicFloat *dptr = &frames[0];
       TonicFloat y;
-      for (int i=0; i<kSynthesisBlockSize; i++){
+      for (int i=0; i<synthesisBlockSize(); i++){
         
         // feedback stage
         y = *dptr + delayBack_.tickOut(delay_) * coef_;
@@ -90,6 +92,10 @@ namespace Tonic {
       
         vector<TonicFloat> reflectTapTimes_;
         vector<TonicFloat> reflectTapScale_;
+      
+        // jitters the reflection tap times
+        Random        random_;
+        bool          reseeded_;
 
         // Comb filters
         vector<FilteredFBCombFilter6> combFilters_[2];
@@ -99,10 +105,6 @@ namespace Tonic {
         // Allpass filters
         vector<ImpulseDiffuserAllpass> allpassFilters_[2];
       
-        // Signal vector workspaces
-        TonicFrames   workspaceFrames_[2];
-        TonicFrames   preOutputFrames_[2];
-      
         // Input generators
         ControlGenerator  preDelayTimeCtrlGen_;
         ControlGenerator  inputFiltBypasCtrlGen_;
@@ -116,6 +118,8 @@ namespace Tonic {
         void updateDelayTimes(const SynthesisContext_ & context);
             
         void computeSynthesisBlock( const SynthesisContext_ &context );
+      
+        void sampleRateChanged();
 
       public:
       
@@ -131,6 +135,8 @@ namespace Tonic {
         void setDecayTimeCtrlGen( ControlGenerator gen ) { decayTimeCtrlGen_ = gen; }
         void setStereoWidthCtrlGen( ControlGenerator gen ) { stereoWidthCtrlGen_ = gen; }
       
+        void setSeed( TonicUInt32 seed ){ random_.seed(seed); reseeded_ = true; }
+      
         // These are special setters, they will be passed to all the comb filters
         void setDecayLPFCtrlGen( ControlGenerator gen );
         void setDecayHPFCtrlGen( ControlGenerator gen );
@@ -141,25 +147,32 @@ namespace Tonic {
       
       updateDelayTimes(context);
       
+      // Signal vector workspaces
+      ScratchFrames_ workspace0(context, 1);
+      ScratchFrames_ workspace1(context, 1);
+      ScratchFrames_ preOutputLeft(context, 1);
+      ScratchFrames_ preOutputRight(context, 1);
+      TonicFrames * preOutputFrames[2] = { &*preOutputLeft, &*preOutputRight };
+      
       // pass thru input filters
       if (inputFiltBypasCtrlGen_.tick(context).value == 0.f){
         
-        inputLPF_.tickThrough(dryFrames_, workspaceFrames_[0], context);
-        inputHPF_.tickThrough(workspaceFrames_[0], workspaceFrames_[0], context);
+        inputLPF_.tickThrough(dryInput(), *workspace0, context);
+        inputHPF_.tickThrough(*workspace0, *workspace0, context);
         
       }
       else{
-        workspaceFrames_[0].copy(dryFrames_);
+        workspace0->copy(dryInput());
       }
       
-      TonicFloat *wkptr0 = &(workspaceFrames_[0])[0];
-      TonicFloat *wkptr1 = &(workspaceFrames_[1])[0];
+      TonicFloat *wkptr0 = &(*workspace0)[0];
+      TonicFloat *wkptr1 = &(*workspace1)[0];
       
       // pass thru pre-delay, input filters, and sum the early reflections
       
       TonicFloat preDelayTime = preDelayTimeCtrlGen_.tick(context).value;
       
-      for (unsigned int i=0; i<kSynthesisBlockSize; i++){
+      for (unsigned int i=0; i<synthesisBlockSize(); i++){
       
         // filtered input is in w0
         // predelay output is in w1
@@ -181,30 +194,30 @@ namespace Tonic {
       }
       
       // Comb filers
-      preOutputFrames_[TONIC_LEFT].clear();
-      preOutputFrames_[TONIC_RIGHT].clear();
+      preOutputFrames[TONIC_LEFT]->clear();
+      preOutputFrames[TONIC_RIGHT]->clear();
       for (unsigned int i=0; i<combFilters_[TONIC_LEFT].size(); i++){
-        combFilters_[TONIC_LEFT][i].tickThrough(workspaceFrames_[0], workspaceFrames_[1], context);
-        preOutputFrames_[TONIC_LEFT] += workspaceFrames_[1];
-        combFilters_[TONIC_RIGHT][i].tickThrough(workspaceFrames_[0], workspaceFrames_[1], context);
-        preOutputFrames_[TONIC_RIGHT] += workspaceFrames_[1];
+        combFilters_[TONIC_LEFT][i].tickThrough(*workspace0, *workspace1, context);
+        *preOutputFrames[TONIC_LEFT] += *workspace1;
+        combFilters_[TONIC_RIGHT][i].tickThrough(*workspace0, *workspace1, context);
+        *preOutputFrames[TONIC_RIGHT] += *workspace1;
       }
       
       // Allpass filters
       for (unsigned int i=0; i<allpassFilters_[TONIC_LEFT].size(); i++){
-        allpassFilters_[TONIC_LEFT][i].tickThrough(preOutputFrames_[TONIC_LEFT]);
-        allpassFilters_[TONIC_RIGHT][i].tickThrough(preOutputFrames_[TONIC_RIGHT]);
+        allpassFilters_[TONIC_LEFT][i].tickThrough(*preOutputFrames[TONIC_LEFT]);
+        allpassFilters_[TONIC_RIGHT][i].tickThrough(*preOutputFrames[TONIC_RIGHT]);
       }
       
       // interleave pre-output frames into output frames
       TonicFloat *outptr = &outputFrames_[0];
-      TonicFloat *preoutptrL = &preOutputFrames_[TONIC_LEFT][0];
-      TonicFloat *preoutptrR = &preOutputFrames_[TONIC_RIGHT][0];
+      TonicFloat *preoutptrL = &(*preOutputFrames[TONIC_LEFT])[0];
+      TonicFloat *preoutptrR = &(*preOutputFrames[TONIC_RIGHT])[0];
       
       TonicFloat spreadValue = clamp(1.0f - stereoWidthCtrlGen_.tick(context).value, 0.f, 1.f);
       TonicFloat normValue = (1.0f/(1.0f+spreadValue))*0.04f; // scale back levels quite a bit
       
-      for (unsigned int i=0; i<kSynthesisBlockSize; i++){
+      for (unsigned int i=0; i<synthesisBlockSize(); i++){
         *outptr++ = (*preoutptrL + (spreadValue * (*preoutptrR)))*normValue;
         *outptr++ = (*preoutptrR++ + (spreadValue * (*preoutptrL++)))*normValue;
       }
@@ -256,6 +269,12 @@ namespace Tonic {
       //! Value 0-1 for stereo width
       TONIC_MAKE_CTRL_GEN_SETTERS(Reverb, stereoWidth, setStereoWidthCtrlGen);
     
+      //! Restart the reflection jitter sequence from a seed. The taps are placed again on the next block.
+      Reverb & seed(TonicUInt32 seed){
+        gen()->setSeed(seed);
+        return *this;
+      }
+    
   };
 }
 
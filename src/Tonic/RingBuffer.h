@@ -213,7 +213,7 @@ namespace Tonic {
     };
     
     // TODO: Maybe make this an Effect_?
-    class RingBufferWriter_ {
+    class RingBufferWriter_ : public RefCounted_ {
       
     protected:
       
@@ -7,13 +7,88 @@
 
 #include "SampleTable.h"
 
+#if (defined (__APPLE__) || defined (__linux__))
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+  #define TONIC_HAS_MMAP
+#endif
+
 namespace Tonic {
   
   namespace Tonic_ {
     
-    SampleTable_::SampleTable_(unsigned int frames, unsigned int channels){
+    SampleTable_::SampleTable_(unsigned int frames, unsigned int channels) :
+      mapping_(NULL),
+      mappingBytes_(0),
+      mappedData_(NULL),
+      mappedFrames_(0),
+      mappedChannels_(0)
+    {
       frames_.resize(frames, min(channels, 2)); // limited to 2 channels
     }
     
+    SampleTable_::~SampleTable_(){
+#ifdef TONIC_HAS_MMAP
+      if (mapping_) munmap(mapping_, mappingBytes_);
+#endif
+    }
+    
+    bool SampleTable_::mapFile(string path, size_t dataOffset, unsigned long frames, unsigned int channels){
+      
+#ifdef TONIC_HAS_MMAP
+      
+      if (channels < 1 || channels > 2){
+        error("SampleTable: invalid number of channels in mapped file " + path);
+        return false;
+      }
+      
+      int fd = open(path.c_str(), O_RDONLY);
+      if (fd < 0) return false;
+      
+      struct stat info;
+      size_t bytes = dataOffset + (size_t)frames * channels * sizeof(TonicFloat);
+      if (fstat(fd, &info) != 0 || (size_t)info.st_size < bytes){
+        close(fd);
+        return false;
+      }
+      
+      // the mapping stays valid after the descriptor is closed
+      void * mapping = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      close(fd);
+      if (mapping == MAP_FAILED) return false;
+      
+      if (mapping_) munmap(mapping_, mappingBytes_);
+      
+      mapping_ = mapping;
+      mappingBytes_ = bytes;
+      mappedData_ = (TonicFloat*)((char*)mapping + dataOffset);
+      mappedFrames_ = frames;
+      mappedChannels_ = channels;
+      return true;
+      
+#else
+      return false;
+#endif
+    }
+    
+    void SampleTable_::unmap(){
+      
+      if (!mapping_) return;
+      
+      frames_.resize(mappedFrames_, mappedChannels_);
+      if (frames_.size() > 0){
+        memcpy(&frames_[0], mappedData_, frames_.size() * sizeof(TonicFloat));
+      }
+      
+#ifdef TONIC_HAS_MMAP
+      munmap(mapping_, mappingBytes_);
+#endif
+      mapping_ = NULL;
+      mappingBytes_ = 0;
+      mappedData_ = NULL;
+    }
+    
   }
-}
\ No newline at end of file
+}
@@ -22,40 +22,65 @@ namespace Tonic {
   
   namespace Tonic_ {
     
-    class SampleTable_ {
+    class SampleTable_ : public RefCounted_ {
       
     protected:
       TonicFrames frames_;
       
+      // Samples in a memory-mapped file, used instead of frames_ when mapped. See mapFile()
+      void *          mapping_;
+      size_t          mappingBytes_;
+      TonicFloat *    mappedData_;
+      unsigned long   mappedFrames_;
+      unsigned int    mappedChannels_;
+      
+      // Copy the mapped samples into frames_ and release the mapping
+      void unmap();
+      
     public:
       
       SampleTable_(unsigned int frames, unsigned int channels);
+      ~SampleTable_();
+      
+      //! Use interleaved float samples stored in a file at byte offset dataOffset, without reading them into memory.
+      /*!
+          Pages are loaded on demand and can be dropped by the OS under memory pressure, since the file backs them.
+          The mapping is copy-on-write, so writing through dataPointer() never modifies the file.
+          Returns false if the file could not be mapped, e.g. on platforms without mmap.
+      */
+      bool mapFile(string path, size_t dataOffset, unsigned long frames, unsigned int channels);
+      
+      bool isMapped() const {
+        return mapping_ != NULL;
+      }
       
       // Property getters
       unsigned int channels() const {
-        return frames_.channels();
+        return mapping_ ? mappedChannels_ : frames_.channels();
       }
       
       unsigned long frames() const {
-        return frames_.frames();
+        return mapping_ ? mappedFrames_ : frames_.frames();
       }
       
       size_t size() const {
-        return frames_.size();
+        return mapping_ ? mappedFrames_ * mappedChannels_ : frames_.size();
       }
       
       // Pointer to start of data array
       TonicFloat * dataPointer() {
-        return &frames_[0];
+        return mapping_ ? mappedData_ : &frames_[0];
       }
       
       // Resize
       void resize(unsigned int frames, unsigned int channels){
+        unmap();
         frames_.resize(frames, channels);
       }
       
       // Resample
       void resample(unsigned int frames, unsigned int channels){
+        unmap();
         frames_.resample(frames, channels);
       }
       
@@ -99,6 +124,15 @@ namespace Tonic {
       obj->resample(frames, channels);
     }
     
+    //! Read samples from a memory-mapped file instead of memory. See Tonic_::SampleTable_::mapFile
+    bool mapFile(string path, size_t dataOffset, unsigned long frames, unsigned int channels){
+      return obj->mapFile(path, dataOffset, frames, channels);
+    }
+    
+    bool isMapped() const {
+      return obj->isMapped();
+    }
+    
   };
 
 }
@@ -30,9 +30,6 @@ namespace Tonic {
       Generator freqGen_;
       Generator slopeGen_;
       
-      TonicFrames freqFrames_;
-      TonicFrames slopeFrames_;
-      
       double phaseAccum_;
       
       void computeSynthesisBlock( const SynthesisContext_ &context );
@@ -40,12 +37,19 @@ namespace Tonic {
     public:
       AngularWave_();
       
+      void appendInputs( vector<Generator_*> & inputs ){
+        inputs.push_back(freqGen_.rawGenerator());
+        inputs.push_back(slopeGen_.rawGenerator());
+      };
+
       void setFrequencyGenerator( Generator gen ){
         freqGen_ = gen;
+        inputsChanged();
       }
       
       void setSlopeGenerator( Generator gen ){
         slopeGen_ = gen;
+        inputsChanged();
       }
       
       
@@ -54,28 +58,23 @@ namespace Tonic {
     inline void AngularWave_::computeSynthesisBlock(const SynthesisContext_ &context){
       
       // tick freq and slope inputs
-      freqGen_.tick(freqFrames_, context);
-      slopeGen_.tick(slopeFrames_, context);
+      ScratchFrames_ freqFrames(context, 1);
+      freqGen_.tick(*freqFrames, context);
+      ScratchFrames_ slopeFrames(context, 1);
+      slopeGen_.tick(*slopeFrames, context);
       
       // calculate the output wave
-      TonicFloat const rateConstant = TONIC_SAW_RES/Tonic::sampleRate();
+      TonicFloat const rateConstant = TONIC_SAW_RES/sampleRate_;
       
       TonicFloat slope, frac, phase;
       TonicFloat *outptr = &outputFrames_[0];
-      TonicFloat *freqptr = &freqFrames_[0];
-      TonicFloat *slopeptr = &slopeFrames_[0];
+      TonicFloat *freqptr = &(*freqFrames)[0];
+      TonicFloat *slopeptr = &(*slopeFrames)[0];
       
       FastPhasor sd;
       
       // pre-multiply rate constant for speed
-#ifdef USE_APPLE_ACCELERATE
-      vDSP_vsmul(freqptr, 1, &rateConstant, freqptr, 1, kSynthesisBlockSize);
-#else
-      for (unsigned int i=0; i<kSynthesisBlockSize; i++){
-        *freqptr++ *= rateConstant;
-      }
-      freqptr = &freqFrames_[0];
-#endif
+      vsmul(freqptr, 1, rateConstant, freqptr, 1, synthesisBlockSize());
       
       sd.d = BIT32DECPT;
       TonicInt32 offs, msbi = sd.i[1];
@@ -129,26 +128,20 @@ namespace Tonic {
     inline void SawtoothWaveBL_::computeSynthesisBlock(const Tonic_::SynthesisContext_ &context)
     {
       
-      static const TonicFloat rateConstant =  1.0f / Tonic::sampleRate();
+      const TonicFloat rateConstant =  1.0f / sampleRate_;
       
       // tick freq and pwm
-      freqGen_.tick(freqFrames_, context);
+      ScratchFrames_ freqFrames(context, 1);
+      freqGen_.tick(*freqFrames, context);
       
       TonicFloat *outptr = &outputFrames_[0];
-      TonicFloat *freqptr = &freqFrames_[0];
+      TonicFloat *freqptr = &(*freqFrames)[0];
       
       // pre-multiply rate constant for speed
-#ifdef USE_APPLE_ACCELERATE
-      vDSP_vsmul(freqptr, 1, &rateConstant, freqptr, 1, kSynthesisBlockSize);
-#else
-      for (unsigned int i=0; i<kSynthesisBlockSize; i++){
-        *freqptr++ *= rateConstant;
-      }
-      freqptr = &freqFrames_[0];
-#endif
+      vsmul(freqptr, 1, rateConstant, freqptr, 1, synthesisBlockSize());
       
       // TODO: Maybe do this using a fast phasor for wraparound speed
-      for (unsigned int i=0; i<kSynthesisBlockSize; i++, freqptr++, outptr++){
+      for (unsigned int i=0; i<synthesisBlockSize(); i++, freqptr++, outptr++){
         
         phase_ += *freqptr;
         
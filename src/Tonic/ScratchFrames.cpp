@@ -0,0 +1,28 @@
+//
+//  ScratchFrames.cpp
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#include "ScratchFrames.h"
+
+namespace Tonic {
+
+  namespace Tonic_ {
+
+    ScratchStack_ & threadScratchStack(){
+#if TONIC_HAS_CPP_11
+      static thread_local ScratchStack_ stack;
+      return stack;
+#else
+      // never deleted, TONIC_THREAD_LOCAL can only hold plain data
+      static TONIC_THREAD_LOCAL ScratchStack_ * stack = NULL;
+      if (!stack) stack = new ScratchStack_();
+      return *stack;
+#endif
+    }
+
+  }
+
+}
@@ -0,0 +1,120 @@
+//
+//  ScratchFrames.h
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#ifndef TONIC_SCRATCHFRAMES_H
+#define TONIC_SCRATCHFRAMES_H
+
+#include "TonicFrames.h"
+
+namespace Tonic {
+
+  namespace Tonic_ {
+
+    //! Stack of block-sized work buffers shared by every node ticked with one SynthesisContext_.
+    /*!
+        Nodes borrow buffers with ScratchFrames_ while they compute and hand them back before
+        returning, so a graph needs only as many buffers as its deepest chain of nested borrows,
+        instead of one or more per node. The few buffers in use stay hot in cache.
+        Owned by a BufferFiller_ and passed down the graph through SynthesisContext_::scratch.
+        Its capacity is set off the audio thread from GraphSchedule_::scratchDepth(), so borrowing
+        never allocates.
+     */
+    class ScratchStack_ {
+
+      vector<TonicFrames*>  frames_;
+      unsigned int          depth_;
+
+      // not copyable
+      ScratchStack_( const ScratchStack_ & );
+      ScratchStack_ & operator=( const ScratchStack_ & );
+
+    public:
+
+      //! Enough for typical graphs
+      static const unsigned int kDefaultCapacity = 8;
+
+      ScratchStack_( unsigned int capacity = kDefaultCapacity ) : depth_(0) {
+        for (unsigned int i=0; i<capacity; i++){
+          frames_.push_back(new TonicFrames(synthesisBlockSize(), 2));
+        }
+      }
+
+      ~ScratchStack_(){
+        for (unsigned int i=0; i<frames_.size(); i++){
+          delete frames_[i];
+        }
+      }
+
+      unsigned int capacity() const { return (unsigned int)frames_.size(); }
+
+      //! Exchange buffers with another stack without allocating. Neither may have blocks borrowed.
+      void swap( ScratchStack_ & other ){
+        frames_.swap(other.frames_);
+      }
+
+      //! Borrow a block with nChannels channels. Contents are undefined.
+      TonicFrames & push( unsigned int nChannels ){
+        // Only reached if the stack was sized for a smaller graph than the one borrowing from it,
+        // e.g. by a generator that doesn't report its inputs (see Generator_::appendInputs)
+        if (depth_ == frames_.size()){
+          frames_.push_back(new TonicFrames(synthesisBlockSize(), 2));
+        }
+        TonicFrames & frames = *frames_[depth_++];
+        frames.resize(synthesisBlockSize(), nChannels);
+        return frames;
+      }
+
+      //! Return the most recently borrowed block
+      void pop(){
+        depth_--;
+      }
+
+    };
+
+    //! Scratch stack for contexts that have none (e.g. DummyContext, or a context ticked by hand), one per thread.
+    ScratchStack_ & threadScratchStack();
+
+    //! Block-sized frames borrowed from the context's ScratchStack_ for the enclosing scope.
+    /*!
+        Contents are undefined when borrowed and are not kept between blocks. Contexts without
+        a scratch stack borrow from the calling thread's threadScratchStack().
+
+        Usage, inside computeSynthesisBlock:
+
+        ScratchFrames_ freqFrames(context, 1);
+        const TonicFrames & freq = freqGen_.output(context, *freqFrames);
+     */
+    class ScratchFrames_ {
+
+      ScratchStack_ & stack_;
+      TonicFrames &   frames_;
+
+      // not copyable
+      ScratchFrames_( const ScratchFrames_ & );
+      ScratchFrames_ & operator=( const ScratchFrames_ & );
+
+    public:
+
+      ScratchFrames_( const SynthesisContext_ & context, unsigned int nChannels ) :
+        stack_(context.scratch ? *context.scratch : threadScratchStack()),
+        frames_(stack_.push(nChannels))
+      {}
+
+      ~ScratchFrames_(){
+        stack_.pop();
+      }
+
+      TonicFrames & operator*() { return frames_; }
+      TonicFrames * operator->() { return &frames_; }
+
+    };
+
+  }
+
+}
+
+#endif
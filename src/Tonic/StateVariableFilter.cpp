@@ -0,0 +1,129 @@
+//
+//  StateVariableFilter.cpp
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#include "StateVariableFilter.h"
+
+namespace Tonic { namespace Tonic_{
+
+  SVF_::SVF_() :
+    inputMix_(0),
+    bandMix_(0),
+    bandDampingMix_(0),
+    lowMix_(0),
+    canNormalizeGain_(true)
+  {
+    ic1eq_[0] = ic1eq_[1] = 0;
+    ic2eq_[0] = ic2eq_[1] = 0;
+    memset(cachedCoef_, 0, sizeof(cachedCoef_));
+  }
+
+  void SVF_::computeSynthesisBlock( const SynthesisContext_ & context ){
+
+    ScratchFrames_ cutoffFrames(context, 1);
+    ScratchFrames_ QFrames(context, 1);
+    const TonicFrames & cutoff = cutoff_.output(context, *cutoffFrames);
+    const TonicFrames & Q = Q_.output(context, *QFrames);
+
+    if (cutoff_.isConstantOutput() && Q_.isConstantOutput()){
+      applyFilter(clamp(cutoff[0], 20, sampleRate_/2), max(Q[0], 0.7071), context);
+      return;
+    }
+
+    // Per-sample coefficients, the same way applyFilter computes them. g = tan(pi * cutoff / rate)
+    // goes into the cutoff workspace and k = 1 / Q into the Q workspace, which are no longer needed.
+    const unsigned int nFrames = synthesisBlockSize();
+    TonicFloat * g = &(*cutoffFrames)[0];
+    TonicFloat * k = &(*QFrames)[0];
+
+    vclip(&cutoff[0], 1, 20, sampleRate_/2, g, 1, nFrames);
+    vsmul(g, 1, PI / sampleRate_, g, 1, nFrames);
+    vtan(g, g, nFrames);
+    vclip(&Q[0], 1, 0.7071f, numeric_limits<TonicFloat>::max(), k, 1, nFrames);
+
+    ScratchFrames_ a1Frames(context, 1);
+    ScratchFrames_ a3Frames(context, 1);
+    TonicFloat * a1 = &(*a1Frames)[0];
+    TonicFloat * a3 = &(*a3Frames)[0];
+
+    // a2 replaces g
+    for (unsigned int i=0; i<nFrames; i++){
+      k[i] = 1.f / k[i];
+      a1[i] = 1.f / (1.f + g[i] * (g[i] + k[i]));
+      a3[i] = g[i] * g[i] * a1[i];
+      g[i] = g[i] * a1[i];
+    }
+
+    filterBlock(a1, g, a3, k, 1);
+  }
+
+  void SVF_::applyFilter( TonicFloat cutoff, TonicFloat Q, const SynthesisContext_ & context ){
+
+    if (parametersChanged(cutoff, Q)){
+      TonicFloat g = cutoff * (PI / sampleRate_);
+      vtan(&g, &g, 1);
+      const TonicFloat k = 1.f / Q;
+      const TonicFloat a1 = 1.f / (1.f + g * (g + k));
+      cachedCoef_[0] = a1;
+      cachedCoef_[1] = g * a1;
+      cachedCoef_[2] = g * g * a1;
+      cachedCoef_[3] = k;
+    }
+
+    filterBlock(cachedCoef_, cachedCoef_ + 1, cachedCoef_ + 2, cachedCoef_ + 3, 0);
+  }
+
+  void SVF_::filterBlock( const TonicFloat * a1, const TonicFloat * a2, const TonicFloat * a3, const TonicFloat * k, unsigned int coefStride ){
+
+    const TonicFloat * in = &dryInput()[0];
+    TonicFloat * out = &outputFrames_[0];
+    const unsigned int nFrames = synthesisBlockSize();
+    const unsigned int nChannels = dryInput().channels();
+
+    // the output is scaled by normK * k + normOne, i.e. by k = 1/Q when normalizing and by 1 otherwise
+    const bool normalize = bNormalizeGain_ && canNormalizeGain_;
+    const TonicFloat normK = normalize ? 1.f : 0.f;
+    const TonicFloat normOne = 1.f - normK;
+
+    // locals, so the compiler can keep them in registers rather than reloading them after every store to out
+    const TonicFloat inputMix = inputMix_;
+    const TonicFloat bandMix = bandMix_;
+    const TonicFloat bandDampingMix = bandDampingMix_;
+    const TonicFloat lowMix = lowMix_;
+    TonicFloat ic1eq[2] = { ic1eq_[0], ic1eq_[1] };
+    TonicFloat ic2eq[2] = { ic2eq_[0], ic2eq_[1] };
+
+    for (unsigned int i=0; i<nFrames; i++){
+
+      const unsigned int c = i * coefStride;
+      const TonicFloat bandGain = bandMix + bandDampingMix * k[c];
+      const TonicFloat gain = normK * k[c] + normOne;
+
+      for (unsigned int ch=0; ch<nChannels; ch++){
+        const TonicFloat v0 = *in++;
+        const TonicFloat v3 = v0 - ic2eq[ch];
+        const TonicFloat v1 = a1[c] * ic1eq[ch] + a2[c] * v3;
+        const TonicFloat v2 = ic2eq[ch] + a2[c] * ic1eq[ch] + a3[c] * v3;
+        ic1eq[ch] = 2.f * v1 - ic1eq[ch];
+        ic2eq[ch] = 2.f * v2 - ic2eq[ch];
+        *out++ = (inputMix * v0 + bandGain * v1 + lowMix * v2) * gain;
+      }
+    }
+
+    ic1eq_[0] = ic1eq[0]; ic1eq_[1] = ic1eq[1];
+    ic2eq_[0] = ic2eq[0]; ic2eq_[1] = ic2eq[1];
+
+#ifdef TONIC_DEBUG
+    if(outputFrames_(0,0) != outputFrames_(0,0)){
+      Tonic::error("SVF_::filterBlock NaN detected.", false);
+    }
+#endif
+
+  }
+
+} // Namespace Tonic_
+
+} // Namespace Tonic
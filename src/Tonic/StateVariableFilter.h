@@ -0,0 +1,106 @@
+//
+//  StateVariableFilter.h
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#ifndef TONIC_STATEVARIABLEFILTER_H
+#define TONIC_STATEVARIABLEFILTER_H
+
+#include "Filters.h"
+
+namespace Tonic {
+
+  namespace Tonic_ {
+
+    // ================================
+    //     State Variable Filter Base
+    // ================================
+
+    //! 2-pole state variable filter, discretized with the topology-preserving transform (trapezoidal integration).
+    /*!
+        Unlike the biquad filters, cutoff and Q are read every sample, so they can be modulated at
+        audio rate without zipper noise or instability. The per-sample coefficients are computed a
+        block at a time with vtan. While cutoff and Q are both constant the coefficients are
+        computed once and reused until either changes.
+
+        Subclasses choose the response by mixing the input, bandpass and lowpass outputs.
+     */
+    class SVF_ : public Filter_ {
+
+    private:
+
+      // integrator states per channel
+      TonicFloat ic1eq_[2];
+      TonicFloat ic2eq_[2];
+
+      // a1, a2, a3 and k for the last constant cutoff and Q
+      TonicFloat cachedCoef_[4];
+
+      void filterBlock( const TonicFloat * a1, const TonicFloat * a2, const TonicFloat * a3, const TonicFloat * k, unsigned int coefStride );
+
+    protected:
+
+      // output = (inputMix_ * input + (bandMix_ + bandDampingMix_ * k) * band + lowMix_ * low), where k = 1/Q
+      TonicFloat inputMix_;
+      TonicFloat bandMix_;
+      TonicFloat bandDampingMix_;
+      TonicFloat lowMix_;
+
+      // whether normalizesGain(true) scales the output by 1/Q, as the biquad filters do
+      bool canNormalizeGain_;
+
+      void computeSynthesisBlock( const SynthesisContext_ & context );
+
+      void applyFilter( TonicFloat cutoff, TonicFloat Q, const SynthesisContext_ & context );
+
+    public:
+
+      SVF_();
+
+    };
+
+    //! State variable lowpass
+    class SVFLPF_ : public SVF_ {
+    public:
+      SVFLPF_() { lowMix_ = 1; }
+    };
+
+    //! State variable highpass
+    class SVFHPF_ : public SVF_ {
+    public:
+      SVFHPF_() { inputMix_ = 1; bandDampingMix_ = -1; lowMix_ = -1; }
+    };
+
+    //! State variable bandpass. With gain normalization the peak gain is 1, otherwise Q.
+    class SVFBPF_ : public SVF_ {
+    public:
+      SVFBPF_() { bandMix_ = 1; }
+    };
+
+    //! State variable band-reject (notch)
+    class SVFBRF_ : public SVF_ {
+    public:
+      SVFBRF_() { inputMix_ = 1; bandDampingMix_ = -1; canNormalizeGain_ = false; }
+    };
+
+  }
+
+  // ------------------- Smart Pointers -----------------------
+
+  // SVF LPF
+  class SVFLPF : public TemplatedFilter<SVFLPF, Tonic_::SVFLPF_>{};
+
+  // SVF HPF
+  class SVFHPF : public TemplatedFilter<SVFHPF, Tonic_::SVFHPF_>{};
+
+  // SVF BPF
+  class SVFBPF : public TemplatedFilter<SVFBPF, Tonic_::SVFBPF_>{};
+
+  // SVF BRF
+  class SVFBRF : public TemplatedFilter<SVFBRF, Tonic_::SVFBRF_>{};
+
+}
+
+#endif
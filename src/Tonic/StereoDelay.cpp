@@ -13,9 +13,6 @@ namespace Tonic { namespace Tonic_{
   StereoDelay_::StereoDelay_(){
     setIsStereoOutput(true);
     setIsStereoInput(true);
-    delayTimeFrames_[TONIC_LEFT].resize(kSynthesisBlockSize, 1, 0);
-    delayTimeFrames_[TONIC_RIGHT].resize(kSynthesisBlockSize, 1, 0);
-    fbkFrames_.resize(kSynthesisBlockSize, 1, 0);
     
     setFeedback(FixedValue(0.0));
     setDryLevelGen(FixedValue(0.5));
@@ -28,6 +25,9 @@ namespace Tonic { namespace Tonic_{
     if (maxDelayRight <= 0) maxDelayRight = rightDelayArg * 1.5;
     delayLine_[TONIC_LEFT].initialize(maxDelayLeft, 1);
     delayLine_[TONIC_RIGHT].initialize(maxDelayRight, 1);
+    
+    // sleep only after a full pass through the delay lines has decayed
+    setSilenceDetection(max(maxDelayLeft, maxDelayRight), silenceThreshold_);
   }
 
   
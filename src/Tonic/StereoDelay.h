@@ -24,31 +24,43 @@ namespace Tonic {
     protected:
     
       Generator delayTimeGen_[2];
-      TonicFrames delayTimeFrames_[2];
-      
       Generator fbkGen_;
-      TonicFrames fbkFrames_;
       
       DelayLine delayLine_[2];
       
       void computeSynthesisBlock( const SynthesisContext_ &context );
       
+      void sampleRateChanged(){
+        delayLine_[TONIC_LEFT].setSampleRate(sampleRate_);
+        delayLine_[TONIC_RIGHT].setSampleRate(sampleRate_);
+      };
+      
     public:
       
       StereoDelay_();
       
+      void appendInputs( vector<Generator_*> & inputs ){
+        WetDryEffect_::appendInputs(inputs);
+        inputs.push_back(delayTimeGen_[0].rawGenerator());
+        inputs.push_back(delayTimeGen_[1].rawGenerator());
+        inputs.push_back(fbkGen_.rawGenerator());
+      };
+
       void initialize(float leftDelayArg, float rightDelayArg, float maxDelayLeft, float maxDelayRight);
       
       void setFeedback(Generator arg){
         fbkGen_ = arg;
+        inputsChanged();
       };
       
       void setDelayTimeLeft(Generator arg){
         delayTimeGen_[0] = arg;
+        inputsChanged();
       };
       
       void setDelayTimeRight(Generator arg){
         delayTimeGen_[1] = arg;
+        inputsChanged();
       };
       
       
@@ -56,18 +68,19 @@ namespace Tonic {
     
     inline void StereoDelay_::computeSynthesisBlock(const SynthesisContext_ &context){
       
-      delayTimeGen_[0].tick(delayTimeFrames_[TONIC_LEFT], context);
-      delayTimeGen_[1].tick(delayTimeFrames_[TONIC_RIGHT], context);
-      fbkGen_.tick(fbkFrames_, context);
+      // modulations are read directly from their generators' output blocks
+      ScratchFrames_ delayTimeFramesLeft(context, 1);
+      ScratchFrames_ delayTimeFramesRight(context, 1);
+      ScratchFrames_ fbkFrames(context, 1);
+      const TonicFloat *delptr_l = &delayTimeGen_[0].output(context, *delayTimeFramesLeft)[0];
+      const TonicFloat *delptr_r = &delayTimeGen_[1].output(context, *delayTimeFramesRight)[0];
+      const TonicFloat *fbkptr = &fbkGen_.output(context, *fbkFrames)[0];
       
       TonicFloat outSamp[2], fbk;
-      TonicFloat *dryptr = &dryFrames_[0];
+      const TonicFloat *dryptr = &dryInput()[0];
       TonicFloat *outptr = &outputFrames_[0];
-      TonicFloat *fbkptr = &fbkFrames_[0];
-      TonicFloat *delptr_l = &(delayTimeFrames_[TONIC_LEFT])[0];
-      TonicFloat *delptr_r = &(delayTimeFrames_[TONIC_RIGHT])[0];
       
-      for (unsigned int i=0; i<kSynthesisBlockSize; i++){
+      for (unsigned int i=0; i<synthesisBlockSize(); i++){
         
         // Don't clamp feeback - be careful! Negative feedback could be interesting.
         fbk = *fbkptr++;
@@ -19,7 +19,7 @@ namespace Tonic {
 
   namespace Tonic_ {
     
-    Synth_::Synth_() : limitOutput_(true) {
+    Synth_::Synth_() : limitOutput_(true), silentFrames_(0) {
       limiter_.setIsStereo(true);
     }
 
@@ -14,6 +14,7 @@
 
 #include <map>
 #include "BufferFiller.h"
+#include "GraphSchedule.h"
 #include "ControlParameter.h"
 #include "CompressorLimiter.h"
 #include "ControlChangeNotifier.h"
@@ -30,10 +31,14 @@ namespace Tonic{
     protected:
       
       Generator     outputGen_;
+      GraphSchedule_ schedule_;
       
       Limiter limiter_;
       bool limitOutput_;
       
+      // frames since outputGen_ went silent, to know when the limiter's lookahead has drained
+      unsigned long silentFrames_;
+      
       std::map<string, ControlParameter> parameters_;
       std::vector<string> orderedParameterNames_;
       std::map<string, ControlChangeNotifier> controlChangeNotifiers_;
@@ -47,10 +52,39 @@ namespace Tonic{
       
       Synth_();
       
-      //! Set the output gen that produces audio for the Synth
-      void  setOutputGen(Generator gen){ outputGen_ = gen; }
+      //! Set the output gen that produces audio for the Synth, and the schedule compiled for it.
+      /*!
+          schedule is swapped with the current one rather than copied, so this doesn't allocate.
+          So is scratch, if it is deeper than the current stack.
+       */
+      void  setOutputGen(Generator gen, GraphSchedule_ & schedule, ScratchStack_ & scratch){
+        outputGen_ = gen;
+        swapSchedule(schedule, scratch);
+      }
+      
+      //! Replace the schedule, e.g. after the graph was rewired. schedule and scratch receive the old ones.
+      void  swapSchedule(GraphSchedule_ & schedule, ScratchStack_ & scratch){
+        schedule_.swap(schedule);
+        if (scratch.capacity() > scratch_.capacity()){
+          scratch_.swap(scratch);
+        }
+        // so generators first computed from the new schedule are reported under their consumers
+        if (synthContext_.profiler){
+          profiler_.prepare(this);
+        }
+      }
+      
+      // voices inside a Mixer compute with the Mixer's context, and borrow from its scratch stack
+      void appendUnscheduledInputs( vector<Generator_*> & inputs ){
+        inputs.push_back(outputGen_.rawGenerator());
+      }
+      
+      bool isScheduleCurrent() const { return schedule_.isCurrent(); }
+      
       const Generator getOutputGen() { return outputGen_; };
       
+      bool canBecomeSilent(){ return outputGen_.rawGenerator()->canBecomeSilent(); };
+      
       void setLimitOutput(bool shouldLimit) { limitOutput_ = shouldLimit; };
       
       ControlParameter addParameter(string name, TonicFloat initialValue);
@@ -82,6 +116,15 @@ namespace Tonic{
     };
     
     inline void Synth_::computeSynthesisBlock(const SynthesisContext_ &context){
+      
+      // Compute the graph in schedule order, so ticking outputGen_ only collects cached output.
+      // Forced output and the first block make every tick recompute, so those use the plain
+      // recursive tick. So does a stale schedule, which may still list generators that were
+      // disconnected and miss ones that were connected. Profiling works either way.
+      // The schedule is only ever compiled off the audio thread (see Synth::updateSchedule), never here.
+      if (!context.forceNewOutput && context.elapsedFrames != 0 && schedule_.isCurrent()){
+        schedule_.run(context);
+      }
 
       outputGen_.tick(outputFrames_, context);
       
@@ -89,9 +132,17 @@ namespace Tonic{
         it->tick(context);
       }
       
-      if (limitOutput_){
+      // Once the limiter's lookahead (at most 10ms) holds nothing but silence, it would only output
+      // silence, so it is skipped and the synth reports silence to let a Mixer skip it too.
+      bool silent = outputGen_.isSilentOutput();
+      bool drained = silent && (!limitOutput_ || silentFrames_ >= (unsigned long)(0.01f * context.sampleRate));
+      silentFrames_ = silent ? silentFrames_ + outputFrames_.frames() : 0;
+      
+      if (limitOutput_ && !drained){
         limiter_.tickThrough(outputFrames_, context);
       }
+      
+      isConstantOutput_ = drained;
     }
     
   }
@@ -100,13 +151,47 @@ namespace Tonic{
   
   class Synth  : public TemplatedBufferFiller<Tonic_::Synth_> {
     
+  protected:
+    
+    // Capacity of the scratch stack to allocate alongside schedule, or 0 if the current one is deep enough
+    unsigned int scratchCapacityFor(const Tonic_::GraphSchedule_ & schedule){
+      return schedule.scratchDepth() > gen()->scratchCapacity() ? schedule.scratchDepth() : 0;
+    }
+    
   public:
         
     //! Set the output gen that produces audio for the Synth
     void  setOutputGen(Generator generator){
+      // compiled before taking the lock, so the audio thread isn't held up by it
+      Tonic_::GraphSchedule_ schedule;
+      schedule.compile(generator.rawGenerator());
+      Tonic_::ScratchStack_ scratch(scratchCapacityFor(schedule));
+      
+      gen()->lockMutex();
+      gen()->setOutputGen(generator, schedule, scratch);
+      gen()->unlockMutex();
+      collectGarbage();
+    }
+    
+    //! Recompile the synth's execution schedule if generators were connected or disconnected since it was compiled.
+    /*!
+        Setters that rewire a generator in the graph make the schedule stale, and a stale schedule isn't run: the synth
+        ticks its graph recursively instead, which is correct but slower, and keeps the generators of the
+        old schedule alive. setParameter() and sendControlChangesToSubscribers() call this, so a synth
+        driven from a control thread recompiles on its own. Allocates when stale, so never call it
+        from the audio thread.
+     */
+    void updateSchedule(){
+      if (gen()->isScheduleCurrent()) return;
+      
+      Tonic_::GraphSchedule_ schedule;
+      schedule.compile(getOutputGen().rawGenerator());
+      Tonic_::ScratchStack_ scratch(scratchCapacityFor(schedule));
+      
       gen()->lockMutex();
-      gen()->setOutputGen(generator);
+      gen()->swapSchedule(schedule, scratch);
       gen()->unlockMutex();
+      collectGarbage();
     }
     
     //! Returns a reference to outputGen
@@ -177,15 +262,18 @@ namespace Tonic{
       sendControlChangesToSubscribers should be called from the UI thread, not the audio thread.
     */
     void sendControlChangesToSubscribers(){
+      updateSchedule();
       gen()->sendControlChangesToSubscribers();
     }
     
     //! Set the value of a control parameter on this synth
     /*!
-        If normalized is true, value will be mapped to defined range of parameter
+        If normalized is true, value will be mapped to defined range of parameter.
+        Also recompiles the schedule if the graph was rewired, see updateSchedule().
      */
     void setParameter(string name, float value = 1.f, bool normalized = false)
     {
+      updateSchedule();
       gen()->setParameter(name, value, normalized);
     }
   
@@ -196,10 +284,17 @@ namespace Tonic{
       return gen()->getParameters();
     }
     
+    //! Recompute every generator on the next block, and recompile the schedule even if it is current
     void forceNewOutput(){
+      Tonic_::GraphSchedule_ schedule;
+      schedule.compile(getOutputGen().rawGenerator());
+      Tonic_::ScratchStack_ scratch(scratchCapacityFor(schedule));
+      
       gen()->lockMutex();
+      gen()->swapSchedule(schedule, scratch);
       gen()->forceNewOutput();
       gen()->unlockMutex();
+      collectGarbage();
     }
             
   };
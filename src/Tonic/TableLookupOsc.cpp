@@ -19,14 +19,13 @@ namespace Tonic {
     }
   
     TableLookupOsc_::TableLookupOsc_() :
-      phase_(0.0)
+      phase_(0)
     {
-      modFrames_.resize(kSynthesisBlockSize, 1);
-      lookupTable_ = SampleTable(kSynthesisBlockSize,1);
+      lookupTable_ = SampleTable(synthesisBlockSize(),1);
     }
     
     void TableLookupOsc_::reset(){
-      phase_ = 0.0f;
+      phase_ = 0;
     }
     
     void TableLookupOsc_::setLookupTable(SampleTable table){
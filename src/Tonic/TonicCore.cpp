@@ -0,0 +1,96 @@
+//
+//  TonicCore.cpp
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#include "TonicCore.h"
+
+namespace Tonic {
+
+  namespace Tonic_ {
+
+    TonicFloat globalSampleRate_ = 44100.f;
+    
+    TonicFloat maxSampleRate_ = 96000.f;
+    
+    unsigned int synthesisBlockSize_ = kDefaultSynthesisBlockSize;
+
+    // Lock-free stack of objects awaiting deletion. Any thread pushes; collect() takes the
+    // whole stack at once, so there is no ABA problem with concurrent pushes.
+    class GarbageQueue_ {
+
+      RefCounted_ * head_;
+
+    public:
+
+      GarbageQueue_() : head_(NULL) {}
+
+      void push( RefCounted_ * obj ){
+        RefCounted_ * head;
+        do {
+          head = head_;
+          obj->nextGarbage_ = head;
+        } while (!TONIC_ATOMIC_CAS_PTR(head_, head, obj));
+      }
+
+      unsigned int collect(){
+        unsigned int count = 0;
+        RefCounted_ * obj;
+        // deleting an object can release (and queue) the objects it owns
+        while ((obj = (RefCounted_*)TONIC_ATOMIC_EXCHANGE_PTR(head_, (RefCounted_*)NULL)) != NULL){
+          while (obj){
+            RefCounted_ * next = obj->nextGarbage_;
+            delete obj;
+            obj = next;
+            count++;
+          }
+        }
+        return count;
+      }
+
+    };
+
+    static GarbageQueue_ garbageQueue_;
+
+    static TONIC_THREAD_LOCAL int deferredDestructionDepth_ = 0;
+
+    void destroy( const RefCounted_ * obj ){
+      if (deferredDestructionDepth_ > 0){
+        garbageQueue_.push(const_cast<RefCounted_*>(obj));
+      }
+      else{
+        delete obj;
+      }
+    }
+
+    void beginDeferredDestruction(){
+      deferredDestructionDepth_++;
+    }
+
+    void endDeferredDestruction(){
+      deferredDestructionDepth_--;
+    }
+
+  }
+
+  unsigned int collectGarbage(){
+    return Tonic_::garbageQueue_.collect();
+  }
+
+  void setSynthesisBlockSize(unsigned int blockSize){
+
+    if (blockSize == 0){
+      error("setSynthesisBlockSize: block size must be greater than zero");
+      return;
+    }
+
+    if ((blockSize & (blockSize - 1)) != 0){
+      warning("setSynthesisBlockSize: block size should be a power of two");
+    }
+
+    Tonic_::synthesisBlockSize_ = blockSize;
+  }
+
+}
@@ -15,13 +15,16 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
 #include <algorithm>
 #include <stdexcept>
+#include <new>
 #include <iostream>
 #include <limits>
 #include <cstring>
 #include <cstdio>
 #include <cmath>
+#include <ctime>
 
 extern "C" {
   #include <stdint.h>
@@ -33,6 +36,14 @@ extern "C" {
 // Determine if C++11 is available. If not, some synths cannot be used. (applies to oF demos, mostly)
 #define TONIC_HAS_CPP_11 (__cplusplus > 199711L)
 
+// Move smart pointers where C++11 allows, so handing them on does not touch the reference count
+#if TONIC_HAS_CPP_11
+  #include <utility>
+  #define TONIC_MOVE(x)           std::move(x)
+#else
+  #define TONIC_MOVE(x)           (x)
+#endif
+
 // Platform-specific macros and includes
 #if defined (__APPLE__)
 
@@ -51,6 +62,17 @@ extern "C" {
   #define TONIC_MUTEX_LOCK(x)     pthread_mutex_lock(&x)
   #define TONIC_MUTEX_UNLOCK(x)   pthread_mutex_unlock(&x)
 
+  // Atomic counters. Increment and decrement evaluate to the new value.
+  #define TONIC_ATOMIC_INT_T          int
+  #define TONIC_ATOMIC_INCREMENT(x)   __sync_add_and_fetch(&x, 1)
+  #define TONIC_ATOMIC_DECREMENT(x)   __sync_sub_and_fetch(&x, 1)
+
+  // Atomic pointer operations. Compare-and-swap evaluates to true if x held expected and was replaced.
+  #define TONIC_ATOMIC_CAS_PTR(x, expected, desired)  __sync_bool_compare_and_swap(&x, expected, desired)
+  #define TONIC_ATOMIC_EXCHANGE_PTR(x, desired)       __sync_lock_test_and_set(&x, desired)
+
+  #define TONIC_THREAD_LOCAL          __thread
+
 #elif (defined (_WIN32) || defined (__WIN32__))
 
   #define WIN32_LEAN_AND_MEAN
@@ -74,6 +96,15 @@ extern "C" {
   #define TONIC_MUTEX_LOCK(x) EnterCriticalSection(&x)
   #define TONIC_MUTEX_UNLOCK(x) LeaveCriticalSection(&x)
 
+  // Windows native atomic counters
+  #define TONIC_ATOMIC_INT_T LONG
+  #define TONIC_ATOMIC_INCREMENT(x) InterlockedIncrement(&x)
+  #define TONIC_ATOMIC_DECREMENT(x) InterlockedDecrement(&x)
+  #define TONIC_ATOMIC_CAS_PTR(x, expected, desired) (InterlockedCompareExchangePointer((PVOID volatile*)&x, desired, expected) == (expected))
+  #define TONIC_ATOMIC_EXCHANGE_PTR(x, desired) InterlockedExchangePointer((PVOID volatile*)&x, desired)
+
+  #define TONIC_THREAD_LOCAL __declspec(thread)
+
 #endif
 
 // --- Macro for enabling denormal rounding on audio thread ---
@@ -86,6 +117,13 @@ extern "C" {
   #define  TONIC_ENABLE_DENORMAL_ROUNDING()
 #endif
 
+// --- Sample buffer layout ---
+
+// TonicFrames sample data starts on a cache line boundary, which also satisfies SSE, AVX, AVX-512 and NEON
+// aligned loads, and is padded to a multiple of TONIC_FRAMES_PADDING samples so vector loops need no scalar tail.
+#define TONIC_FRAMES_ALIGNMENT    64
+#define TONIC_FRAMES_PADDING      16
+
 
 using namespace std;
 
@@ -117,26 +155,79 @@ namespace Tonic {
   /*! Objects under the Tonic_ namespace are internal DSP-level objects not intended for public usage */
   namespace Tonic_ {
     
-    static TonicFloat sampleRate_ = 44100.f;
+    extern TonicFloat globalSampleRate_;
+    
+    extern TonicFloat maxSampleRate_;
+    
+    extern unsigned int synthesisBlockSize_;
+    
+    //! Allocate aligned memory from the arena active on this thread (see ArenaScope), or from the heap.
+    /*! alignment must be a power of two, and is at least 16 bytes. */
+    void * allocate( size_t bytes, size_t alignment = 16 );
+    
+    //! Free memory returned by allocate(), from any thread
+    void deallocate( void * ptr );
     
   }
   
   // -- Global Constants --
   
-  //! Set the operational sample rate.
-  /*! !!!: CHANGING WHILE RUNNING WILL RESULT IN UNDEFINED BEHAVIOR. MUST BE SET PRIOR TO OBJECT ALLOCATION. */
-  static void setSampleRate(TonicFloat sampleRate){
-    Tonic_::sampleRate_ = sampleRate;
+  //! Set the default sample rate.
+  /*!
+      Used by newly created Synths/Mixers and for buffer allocation. Each engine carries its own rate
+      in its SynthesisContext_, which can be changed while running with BufferFiller::setSampleRate.
+  */
+  inline void setSampleRate(TonicFloat sampleRate){
+    Tonic_::globalSampleRate_ = sampleRate;
   }
   
-  //! Return sample rate
-  static TonicFloat sampleRate(){
-    return Tonic_::sampleRate_;
+  //! Return default sample rate
+  inline TonicFloat sampleRate(){
+    return Tonic_::globalSampleRate_;
   };
+  
+  //! Set the highest sample rate delay buffers are sized for when they are built. Defaults to 96000.
+  /*!
+      Switching an engine to any rate up to this one never allocates. Above it, delay buffers are
+      reallocated on the audio thread before their next block. Affects objects created afterwards.
+  */
+  inline void setMaxSampleRate(TonicFloat sampleRate){
+    Tonic_::maxSampleRate_ = sampleRate;
+  }
+  
+  //! Return the highest sample rate delay buffers are sized for
+  inline TonicFloat maxSampleRate(){
+    return Tonic_::maxSampleRate_;
+  }
 
-  //! "Vector" size for audio processing. ControlGenerators update at this rate.
-  /*! !!!: THIS VALUE SHOULD BE A POWER-OF-TWO WHICH IS LESS THAN THE HARDWARE BUFFER SIZE */
-  static const unsigned int kSynthesisBlockSize = 64;
+  //! Default "vector" size for audio processing
+  static const unsigned int kDefaultSynthesisBlockSize = 64;
+  
+  //! Set the "vector" size for audio processing. ControlGenerators update once per block.
+  /*!
+      Smaller blocks give finer control-rate resolution and lower latency, larger blocks have less
+      per-block overhead and render faster. Defaults to kDefaultSynthesisBlockSize.
+      The block size is shared by the whole process, not set per Synth: one process can't run a
+      16-frame engine next to a 512-frame one.
+      !!!: THIS VALUE SHOULD BE A POWER-OF-TWO WHICH IS LESS THAN THE HARDWARE BUFFER SIZE
+      !!!: CHANGING WHILE RUNNING WILL RESULT IN UNDEFINED BEHAVIOR. MUST BE SET PRIOR TO OBJECT ALLOCATION,
+      !!!: AND NEVER WHILE ANY SYNTH OR MIXER IS RUNNING.
+  */
+  void setSynthesisBlockSize(unsigned int blockSize);
+  
+  //! "Vector" size for audio processing, in frames.
+  inline static unsigned int synthesisBlockSize(){
+    return Tonic_::synthesisBlockSize_;
+  }
+  
+  namespace Tonic_ {
+    struct SynthesisBlockSizeAlias_ {
+      operator unsigned int() const { return synthesisBlockSize(); }
+    };
+  }
+  
+  //! Deprecated: use synthesisBlockSize(). Reads the current block size, so it is no longer a compile-time constant.
+  static const Tonic_::SynthesisBlockSizeAlias_ kSynthesisBlockSize = Tonic_::SynthesisBlockSizeAlias_();
   
   // -- Global Types --
   
@@ -150,6 +241,9 @@ namespace Tonic {
   
   namespace Tonic_{
     
+    class Profiler_;
+    class ScratchStack_;
+    
     //! Context which defines a particular synthesis graph
     
     /*! 
@@ -168,12 +262,21 @@ namespace Tonic {
       //! If true, generators will be forced to compute fresh output
       // TODO: Not fully implmenented yet -- ND 2013/05/20
       bool forceNewOutput;
+      
+      //! If non-NULL, generators report their computation time to this profiler
+      Profiler_ * profiler;
+      
+      //! Sample rate of this synthesis graph. Generators recompute rate-dependent state when it changes.
+      TonicFloat sampleRate;
+      
+      //! Work buffers shared by all generators in this graph, borrowed with ScratchFrames_. If NULL, each thread uses its own.
+      ScratchStack_ * scratch;
             
-      SynthesisContext_() : elapsedFrames(0), elapsedTime(0), forceNewOutput(true){}
+      SynthesisContext_() : elapsedFrames(0), elapsedTime(0), forceNewOutput(true), profiler(NULL), sampleRate(Tonic::sampleRate()), scratch(NULL){}
     
       void tick() {
-        elapsedFrames += kSynthesisBlockSize;
-        elapsedTime = (double)elapsedFrames/sampleRate();
+        elapsedFrames += synthesisBlockSize();
+        elapsedTime = (double)elapsedFrames/sampleRate;
         forceNewOutput = false;
       };
     
@@ -292,16 +395,25 @@ namespace Tonic {
   
   // -- Misc --
   
-  inline static TonicFloat randomSample(){
-    return ((TonicFloat)rand()/RAND_MAX) * 2.0f - 1.0f;
-  }
+  //! Uniform random sample in [-1, 1), from a generator private to the calling thread. See Random.h.
+  TonicFloat randomSample();
   
-  static float randomFloat(float a, float b) {
-    float random = ((float) rand()) / (float) RAND_MAX;
-    float diff = b - a;
-    float r = random * diff;
-    return a + r;
-}
+  //! Uniform random float in [a, b), from a generator private to the calling thread. See Random.h.
+  float randomFloat(float a, float b);
+
+  //! Monotonic wall-clock time in seconds. For measuring render performance, not for scheduling audio.
+  inline static double hostTimeSeconds(){
+#if (defined (_WIN32) || defined (__WIN32__))
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+  }
 
   //! Tonic exception class
   // May want to implement custom exception behavior here, but for now, this is essentially a typedef
@@ -373,22 +485,99 @@ namespace Tonic {
     
   };
   
+  namespace Tonic_ {
+    
+    //! Base class for objects owned by TonicSmartPointer.
+    /*!
+        The reference count lives inside the object, so creating a smart pointer costs no extra
+        allocation. The count is atomic, so smart pointers to the same object can be copied and
+        destroyed on different threads (e.g. a graph built on the UI thread and released on the
+        audio thread). The object itself is not made thread-safe by this.
+     */
+    class RefCounted_ {
+      
+      mutable TONIC_ATOMIC_INT_T refCount_;
+      
+      // link in the queue of objects awaiting collectGarbage()
+      friend class GarbageQueue_;
+      RefCounted_ * nextGarbage_;
+      
+    public:
+      
+      RefCounted_() : refCount_(0), nextGarbage_(NULL) {}
+      
+      // A copy is a new object, not owned by the original's smart pointers
+      RefCounted_(const RefCounted_&) : refCount_(0), nextGarbage_(NULL) {}
+      RefCounted_& operator=(const RefCounted_&){ return *this; }
+      
+      virtual ~RefCounted_() {}
+      
+      // Allocated from the current arena, if any
+      static void * operator new( size_t bytes ){
+        void * ptr = allocate(bytes);
+        if (!ptr) throw std::bad_alloc();
+        return ptr;
+      }
+      
+      static void operator delete( void * ptr ){
+        deallocate(ptr);
+      }
+      
+      void retain() const { TONIC_ATOMIC_INCREMENT(refCount_); }
+      
+      //! Returns true if the last reference was released and the object should be deleted
+      bool release() const { return TONIC_ATOMIC_DECREMENT(refCount_) == 0; }
+      
+      //! Number of references held. Only a snapshot while other threads may retain or release the object.
+      int referenceCount() const { return *(volatile TONIC_ATOMIC_INT_T*)&refCount_; }
+      
+    };
+    
+    //! Delete an object whose last reference was released.
+    /*!
+        While the calling thread holds a BufferFiller's mutex, the audio thread is (or may be) waiting,
+        so the object is queued for collectGarbage() instead of being destroyed there and then.
+     */
+    void destroy( const RefCounted_ * obj );
+    
+    //! Queue objects released on this thread for collectGarbage() instead of deleting them, until the matching end call. Nestable.
+    void beginDeferredDestruction();
+    void endDeferredDestruction();
+    
+  }
+  
+  //! Free objects whose last reference was released while audio processing could have been waiting on them.
+  /*!
+      Graphs replaced while a Synth or Mixer is locked (setOutputGen, removeInput, setters on a running
+      graph) or released on the audio thread are queued rather than freed in place, because freeing
+      delay lines or reverbs can take longer than an audio callback. Synth::setOutputGen and
+      Mixer::removeInput collect after unlocking. Call this periodically from a non-audio thread
+      (e.g. once per UI frame) to free anything else. Never call it from the audio thread.
+      Returns the number of objects freed.
+   */
+  unsigned int collectGarbage();
+  
   //! Reference counting smart pointer class template
+  /*!
+      T must derive from Tonic_::RefCounted_. Any number of smart pointers can be made from
+      the same raw pointer, since the count is kept by the object.
+   */
   template<class T>
   class TonicSmartPointer {
     
     protected:
       
       T * obj;
-      int * pcount;
       
     public:
       
-      TonicSmartPointer() : obj(NULL), pcount(NULL) {}
+      TonicSmartPointer() : obj(NULL) {}
       
-      TonicSmartPointer(T * initObj) : obj(initObj) , pcount(initObj ? new int(1) : NULL) {}
+      TonicSmartPointer(T * initObj) : obj(initObj) {
+        retain();
+      }
       
-      TonicSmartPointer(const TonicSmartPointer& r) : obj(r.obj), pcount(r.pcount){
+      TonicSmartPointer(const TonicSmartPointer& r) : obj(r.obj){
         retain();
       }
       
@@ -396,37 +585,59 @@ namespace Tonic {
       {
         if(obj == r.obj) return *this;
         
-        release();
+        // retain the new object before releasing the old one, which may own it
+        T * oldObj = obj;
+        obj = r.obj;
+        retain();
+        
+        if (oldObj && oldObj->release()) Tonic_::destroy(oldObj);
         
+        return *this;
+      }
+      
+#if TONIC_HAS_CPP_11
+      // Moving takes over the reference, leaving r empty
+      TonicSmartPointer(TonicSmartPointer&& r) : obj(r.obj){
+        r.obj = NULL;
+      }
+      
+      TonicSmartPointer& operator=(TonicSmartPointer&& r)
+      {
+        if (this == &r) return *this;
+        
+        T * oldObj = obj;
         obj = r.obj;
-        pcount = r.pcount;
+        r.obj = NULL;
         
-        retain();
+        if (oldObj && oldObj->release()) Tonic_::destroy(oldObj);
         
         return *this;
       }
+#endif
       
       ~TonicSmartPointer(){
         release();
       }
       
       void retain(){
-        if (pcount) (*pcount)++;
+        if (obj) obj->retain();
       }
       
       void release(){
-        if(pcount && --(*pcount) == 0){
-          delete obj;
-          delete pcount;
-          
-          obj = NULL;
-          pcount = NULL;
+        if(obj && obj->release()){
+          Tonic_::destroy(obj);
         }
+        obj = NULL;
       }
       
       bool operator==(const TonicSmartPointer& r){
         return obj == r.obj;
       }
+      
+      //! Whether no other smart pointer references the object. Only a snapshot while other threads hold references too.
+      bool isUnique() const {
+        return obj && obj->referenceCount() == 1;
+      }
     
   };
 
@@ -22,16 +22,11 @@ TonicFrames :: TonicFrames( unsigned int nFrames, unsigned int nChannels )
   }
   
   size_ = nFrames_ * nChannels_;
-  bufferSize_ = size_;
+  bufferSize_ = 0;
 
   if ( size_ > 0 ) {
-    data_ = (TonicFloat *) calloc( size_, sizeof( TonicFloat ) );
-#if defined(TONIC_DEBUG)
-    if ( data_ == NULL ) {
-      std::string error = "TonicFrames: memory allocation error in constructor!";
-      Tonic::error(error, true);
-    }
-#endif
+    data_ = allocateData( size_ );
+    if ( data_ ) memset( data_, 0, size_ * sizeof( TonicFloat ) );
   }
   else data_ = 0;
 
@@ -46,16 +41,10 @@ TonicFrames :: TonicFrames( const TonicFloat& value, unsigned int nFrames, unsig
   }
   
   size_ = nFrames_ * nChannels_;
-  bufferSize_ = size_;
+  bufferSize_ = 0;
   if ( size_ > 0 ) {
-    data_ = (TonicFloat *) malloc( size_ * sizeof( TonicFloat ) );
-#if defined(TONIC_DEBUG)
-    if ( data_ == NULL ) {
-      std::string error = "TonicFrames: memory allocation error in constructor!";
-      Tonic::error(error, true);
-    }
-#endif
-    for ( long i=0; i<(long)size_; i++ ) data_[i] = value;
+    data_ = allocateData( size_ );
+    if ( data_ ) for ( long i=0; i<(long)size_; i++ ) data_[i] = value;
   }
   else data_ = 0;
 
@@ -64,27 +53,77 @@ TonicFrames :: TonicFrames( const TonicFloat& value, unsigned int nFrames, unsig
 
 TonicFrames :: ~TonicFrames()
 {
-  if ( data_ ) free( data_ );
+  if ( data_ ) Tonic_::deallocate( data_ );
 }
 
 TonicFrames :: TonicFrames( const TonicFrames& f )
-  : size_(0), bufferSize_(0)
+  : data_(0), dataRate_(f.dataRate_), nFrames_(0), nChannels_(0), size_(0), bufferSize_(0)
 {
   resize( f.frames(), f.channels() );
-  dataRate_ = Tonic::sampleRate();
-  for ( unsigned int i=0; i<size_; i++ ) data_[i] = f[i];
+  if ( size_ > 0 ) memcpy( data_, f.data_, size_ * sizeof( TonicFloat ) );
 }
 
 TonicFrames& TonicFrames :: operator= ( const TonicFrames& f )
 {
-  size_ = 0;
-  bufferSize_ = 0;
-  resize( f.frames(), f.channels() );
-  dataRate_ = Tonic::sampleRate();
-  for ( unsigned int i=0; i<size_; i++ ) data_[i] = f[i];
+  if ( &f != this ) {
+    resize( f.frames(), f.channels() );
+    dataRate_ = f.dataRate_;
+    if ( size_ > 0 ) memcpy( data_, f.data_, size_ * sizeof( TonicFloat ) );
+  }
   return *this;
 }
 
+#if TONIC_HAS_CPP_11
+
+TonicFrames :: TonicFrames( TonicFrames&& f )
+  : data_(f.data_), dataRate_(f.dataRate_), nFrames_(f.nFrames_), nChannels_(f.nChannels_), size_(f.size_), bufferSize_(f.bufferSize_)
+{
+  f.data_ = 0;
+  f.nFrames_ = 0;
+  f.nChannels_ = 0;
+  f.size_ = 0;
+  f.bufferSize_ = 0;
+}
+
+TonicFrames& TonicFrames :: operator= ( TonicFrames&& f )
+{
+  if ( &f != this ) {
+    if ( data_ ) Tonic_::deallocate( data_ );
+    data_ = f.data_;
+    dataRate_ = f.dataRate_;
+    nFrames_ = f.nFrames_;
+    nChannels_ = f.nChannels_;
+    size_ = f.size_;
+    bufferSize_ = f.bufferSize_;
+    f.data_ = 0;
+    f.nFrames_ = 0;
+    f.nChannels_ = 0;
+    f.size_ = 0;
+    f.bufferSize_ = 0;
+  }
+  return *this;
+}
+
+#endif
+
+TonicFloat * TonicFrames :: allocateData( size_t nSamples )
+{
+  bufferSize_ = (nSamples + TONIC_FRAMES_PADDING - 1) & ~(size_t)(TONIC_FRAMES_PADDING - 1);
+  TonicFloat * data = (TonicFloat *) Tonic_::allocate( bufferSize_ * sizeof( TonicFloat ), TONIC_FRAMES_ALIGNMENT );
+
+  if ( data == NULL ) {
+    bufferSize_ = 0;
+#if defined(TONIC_DEBUG)
+    Tonic::error("TonicFrames: memory allocation error!", true);
+#endif
+    return NULL;
+  }
+
+  // zero the padding so whole-vector reads past size() see defined values
+  memset( data + nSamples, 0, (bufferSize_ - nSamples) * sizeof( TonicFloat ) );
+  return data;
+}
+
 void TonicFrames :: resize( size_t nFrames, unsigned int nChannels )
 {
   
@@ -105,24 +144,13 @@ void TonicFrames :: resize( size_t nFrames, unsigned int nChannels )
     
     if ( size_ > bufferSize_ ) {
       
-      data_ = (TonicFloat *) malloc( size_ * sizeof( TonicFloat ) );
-      
-      if (oldData){
-        for (unsigned int i=0; i<oldSize; i++){
-          data_[i] = oldData[i];
-        }
-      }
+      data_ = allocateData( size_ );
       
-#if defined(TONIC_DEBUG)
-      if ( data_ == NULL ) {
-        std::string error = "TonicFrames::resize: memory allocation error!";
-        Tonic::error(error, true);
+      if (oldData && data_){
+        memcpy( data_, oldData, oldSize * sizeof( TonicFloat ) );
       }
-#endif
-      
-      bufferSize_ = size_;
       
-      if (oldData) free(oldData);
+      if (oldData) Tonic_::deallocate(oldData);
     }
     
   }
@@ -132,11 +160,7 @@ void TonicFrames :: resize( size_t nFrames, unsigned int nChannels, TonicFloat v
 {
   this->resize( nFrames, nChannels );
 
-#ifdef USE_APPLE_ACCELERATE
-  vDSP_vfill(&value, data_, 1, size_);
-#else
-  for ( size_t i=0; i<size_; i++ ) data_[i] = value;
-#endif
+  vfill(value, data_, 1, (unsigned int)size_);
   
 }
   
@@ -159,14 +183,7 @@ void TonicFrames :: resample( size_t nFrames , unsigned int nChannels )
       
       size_ = nFrames_ * nChannels_;
         
-      data_ = (TonicFloat *) malloc( size_ * sizeof( TonicFloat ) );
-      
-#if defined(TONIC_DEBUG)
-      if ( data_ == NULL ) {
-        std::string error = "TonicFrames::resize: memory allocation error!";
-        Tonic::error(error, true);
-      }
-#endif
+      data_ = allocateData( size_ );
       
       // resample the content (brute-force, no AA applied)
       if (oldData){
@@ -208,9 +225,7 @@ void TonicFrames :: resample( size_t nFrames , unsigned int nChannels )
         }
       }
       
-      bufferSize_ = size_;
-      
-      if (oldData) free(oldData);
+      if (oldData) Tonic_::deallocate(oldData);
     
     }
 
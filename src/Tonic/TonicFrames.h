@@ -13,6 +13,7 @@
 #define TONIC_TONICFRAMES_H
 
 #include "TonicCore.h"
+#include "VectorMath.h"
 #include <sstream>
 
 /*
@@ -36,12 +37,20 @@ namespace Tonic {
     //! The destructor.
     virtual ~TonicFrames();
 
-    // A copy constructor.
+    //! Copy constructor. Copies the samples and data rate of \c f.
     TonicFrames( const TonicFrames& f );
 
-    // Assignment operator that returns a reference to self.
+    //! Assignment operator that returns a reference to self. Reuses the existing buffer when it is large enough.
     TonicFrames& operator= ( const TonicFrames& f );
 
+#if TONIC_HAS_CPP_11
+    //! Move constructor. Takes over the buffer of \c f, leaving it empty.
+    TonicFrames( TonicFrames&& f );
+
+    //! Move assignment. Takes over the buffer of \c f, leaving it empty.
+    TonicFrames& operator= ( TonicFrames&& f );
+#endif
+
     //! Subscript operator that returns a reference to element \c n of self.
     /*!
       The result can be used as an lvalue. This reference is valid
@@ -51,12 +60,12 @@ namespace Tonic {
     */
     TonicFloat& operator[] ( size_t n );
 
-    //! Subscript operator that returns the value at element \c n of self.
+    //! Subscript operator that returns a read-only reference to element \c n of self.
     /*!
       The index \c n must be between 0 and size less one.  No range
       checking is performed unless TONIC_DEBUG is defined.
     */
-    TonicFloat operator[] ( size_t n ) const;
+    const TonicFloat& operator[] ( size_t n ) const;
 
     //! Assignment by sum operator into self.
     /*!
@@ -64,10 +73,10 @@ namespace Tonic {
       self.  No range checking is performed unless TONIC_DEBUG is
       defined.
     */
-    void operator+= ( TonicFrames& f );
+    void operator+= ( const TonicFrames& f );
     
     
-    void operator-= ( TonicFrames& f );
+    void operator-= ( const TonicFrames& f );
 
     //! Assignment by product operator into self.
     /*!
@@ -75,10 +84,16 @@ namespace Tonic {
       self.  No range checking is performed unless TONIC_DEBUG is
       defined.
     */
-    void operator*= ( TonicFrames& f );
+    void operator*= ( const TonicFrames& f );
     
     
-    void operator/= ( TonicFrames& f );
+    void operator/= ( const TonicFrames& f );
+    
+    //! Scalar arithmetic applied to every sample, e.g. when an operand is constant across the block.
+    void operator+= ( TonicFloat value );
+    void operator-= ( TonicFloat value );
+    void operator*= ( TonicFloat value );
+    void operator/= ( TonicFloat value );
 
     //! Channel / frame subscript operator that returns a reference.
     /*!
@@ -90,13 +105,13 @@ namespace Tonic {
     */
     TonicFloat& operator() ( size_t frame, unsigned int channel );
 
-    //! Channel / frame subscript operator that returns a value.
+    //! Channel / frame subscript operator that returns a read-only reference.
     /*!
       The \c frame index must be between 0 and frames() - 1.  The \c
       channel index must be between 0 and channels() - 1.  No range checking
       is performed unless TONIC_DEBUG is defined.
     */
-    TonicFloat operator() ( size_t frame, unsigned int channel ) const;
+    const TonicFloat& operator() ( size_t frame, unsigned int channel ) const;
       
       
     //! Copy one channel to another
@@ -112,13 +127,16 @@ namespace Tonic {
     //! clear the frames data
     void clear();
     
+    //! Set every sample to value
+    void fill( TonicFloat value );
+    
     //! Fill frames from other source.
     /*! 
       Copies channels from one object to another. Frame count must match.
       If source has more channels than destination, they will be averaged.
       If destination has more channels than source, they will be copied to all channels.
     */
-    void copy( TonicFrames & f );
+    void copy( const TonicFrames & f );
         
     //! Return an interpolated value at the fractional frame index and channel.
     /*!
@@ -132,6 +150,14 @@ namespace Tonic {
     //! Returns the total number of audio samples represented by the object.
     size_t size() const { return size_; }; 
 
+    //! Returns size() rounded up to a multiple of TONIC_FRAMES_PADDING.
+    /*!
+      The sample data is aligned to TONIC_FRAMES_ALIGNMENT bytes, and may be read and written
+      up to paddedSize(), so vector loops can process whole vectors without a scalar tail.
+      The contents of the padding are undefined.
+    */
+    size_t paddedSize() const { return (size_ + TONIC_FRAMES_PADDING - 1) & ~(size_t)(TONIC_FRAMES_PADDING - 1); };
+
     //! Returns \e true if the object size is zero and \e false otherwise.
     bool empty() const;
 
@@ -181,6 +207,9 @@ namespace Tonic {
 
   protected:
 
+    // Allocate aligned, padded storage for at least nSamples samples. Sets bufferSize_ to the padded size.
+    TonicFloat * allocateData( size_t nSamples );
+
     TonicFloat *data_;
     TonicFloat dataRate_;
     size_t nFrames_;
@@ -209,7 +238,7 @@ namespace Tonic {
     return data_[n];
   }
 
-  inline TonicFloat TonicFrames :: operator[] ( size_t n ) const
+  inline const TonicFloat& TonicFrames :: operator[] ( size_t n ) const
   {
   #if defined(TONIC_DEBUG)
     if ( n >= size_ ) {
@@ -235,7 +264,7 @@ namespace Tonic {
     return data_[ frame * nChannels_ + channel ];
   }
 
-  inline TonicFloat TonicFrames :: operator() ( size_t frame, unsigned int channel ) const
+  inline const TonicFloat& TonicFrames :: operator() ( size_t frame, unsigned int channel ) const
   {
   #if defined(TONIC_DEBUG)
     if ( frame >= nFrames_ || channel >= nChannels_ ) {
@@ -270,41 +299,31 @@ namespace Tonic {
     memset(data_, 0, size_ * sizeof(TonicFloat));
   }
   
-  inline void TonicFrames::copy( TonicFrames &f ){
+  inline void TonicFrames::fill( TonicFloat value ){
+    vfill(value, data_, 1, (unsigned int)size_);
+  }
+  
+  inline void TonicFrames::copy( const TonicFrames &f ){
     
 #if defined(TONIC_DEBUG)
-    if ( f.frames() != nFrames_) {
+    if ( f.frames() != nFrames_ ) {
       std::ostringstream error;
-      error << "TonicFrames::operator+=: frames argument must be of equal dimensions!";
+      error << "TonicFrames::copy: frames argument must be of equal dimensions!";
       Tonic::error(error.str(), true);
     }
 #endif
     
     unsigned int fChannels = f.channels();
     TonicFloat *dptr = data_;
-    TonicFloat *fptr = &f[0];
+    const TonicFloat *fptr = f.data_;
     
     if (nChannels_ == fChannels){
       memcpy(dptr, fptr, size_ * sizeof(TonicFloat));
     }
     else if (nChannels_ < fChannels){
-      
-      // sum channels
-      memset(dptr, 0, size_ * sizeof(TonicFloat));
-      for (unsigned int c=0; c<fChannels; c++){
-        dptr = data_;
-        fptr = &f(0,c);
-        for (unsigned int i=0; i<nFrames_; i++, dptr+=nChannels_, fptr+=fChannels){
-          *dptr += *fptr;
-        }
-      }
-      
-      // apply scaling (average of channels)
-      TonicFloat s = 1.0f/fChannels;
-      dptr = data_;
-      for (unsigned int i=0; i<nFrames_; i++, dptr+=nChannels_){
-        *dptr *= s;
-      }
+      // average stereo down to mono
+      vadd(fptr, 2, fptr + 1, 2, dptr, 1, (unsigned int)nFrames_);
+      vsmul(dptr, 1, 0.5f, dptr, 1, (unsigned int)nFrames_);
     }
     else{
       // just copy one channel, then fill
@@ -316,223 +335,142 @@ namespace Tonic {
       
   }
 
-  inline void TonicFrames :: operator+= ( TonicFrames& f )
+  inline void TonicFrames :: operator+= ( const TonicFrames& f )
   {
-  #if defined(TONIC_DEBUG)
+#if defined(TONIC_DEBUG)
     if ( f.frames() != nFrames_ ) {
       std::ostringstream error;
       error << "TonicFrames::operator+=: frames argument must be of equal dimensions!";
       Tonic::error(error.str(), true);
     }
-  #endif
+#endif
     
-    TonicFloat *fptr = &f[0];
+    const TonicFloat *fptr = f.data_;
     TonicFloat *dptr = data_;
     
     unsigned int fChannels = f.channels();
     
     if (nChannels_ == fChannels){
-      
-#ifdef USE_APPLE_ACCELERATE
-      vDSP_vadd(dptr, 1, fptr, 1, dptr, 1, size_);
-#else
-      for ( unsigned int i=0; i<size_; i++ )
-        *dptr++ += *fptr++;
-#endif
-      
+      vadd(dptr, 1, fptr, 1, dptr, 1, (unsigned int)size_);
     }
     else if (nChannels_ < fChannels){
-      
       //  just add first channel of rhs
-#ifdef USE_APPLE_ACCELERATE
-      vDSP_vadd(dptr, 1, fptr, fChannels, dptr, 1, nFrames_);
-#else
-      for ( unsigned int i=0; i<nFrames_; i++ ){
-        *dptr++ -= *fptr++;
-        fptr++;
-      }
-#endif
-      
+      vadd(dptr, 1, fptr, fChannels, dptr, 1, (unsigned int)nFrames_);
     }
     else{
       //  add rhs to both channels
-#ifdef USE_APPLE_ACCELERATE
-      vDSP_vadd(dptr, 2, fptr, 1, dptr, 2, nFrames_);
-      vDSP_vadd(dptr+1, 2, fptr, 1, dptr+1, 2, nFrames_);
-#else
-      for ( unsigned int i=0; i<nFrames_; i++ ){
-        *dptr++ += *fptr;
-        *dptr++ += *fptr++;
-      }
-#endif
+      vadd(dptr, 2, fptr, 1, dptr, 2, (unsigned int)nFrames_);
+      vadd(dptr+1, 2, fptr, 1, dptr+1, 2, (unsigned int)nFrames_);
     }
-    
   }
   
-  
-  inline void TonicFrames :: operator -= ( TonicFrames& f )
+  inline void TonicFrames :: operator-= ( const TonicFrames& f )
   {
-  #if defined(TONIC_DEBUG)
+#if defined(TONIC_DEBUG)
     if ( f.frames() != nFrames_ ) {
       std::ostringstream error;
-      error << "TonicFrames::operator+=: frames argument must be of equal dimensions!";
+      error << "TonicFrames::operator-=: frames argument must be of equal dimensions!";
       Tonic::error(error.str(), true);
     }
-  #endif
-
+#endif
     
-    TonicFloat *fptr = &f[0];
+    const TonicFloat *fptr = f.data_;
     TonicFloat *dptr = data_;
-
+    
     unsigned int fChannels = f.channels();
     
     if (nChannels_ == fChannels){
-      
-#ifdef USE_APPLE_ACCELERATE
-      vDSP_vsub(fptr, 1, dptr, 1, dptr, 1, size_);
-#else
-      for ( unsigned int i=0; i<size_; i++ )
-        *dptr++ -= *fptr++;
-#endif
+      vsub(dptr, 1, fptr, 1, dptr, 1, (unsigned int)size_);
     }
     else if (nChannels_ < fChannels){
-      
       //  just subtract first channel of rhs
-#ifdef USE_APPLE_ACCELERATE
-      vDSP_vsub(dptr, 1, fptr, fChannels, dptr, 1, nFrames_);
-#else
-      for ( unsigned int i=0; i<nFrames_; i++ ){
-        *dptr++ -= *fptr++;
-        fptr++;
-      }
-#endif
-      
+      vsub(dptr, 1, fptr, fChannels, dptr, 1, (unsigned int)nFrames_);
     }
     else{
-      //  subtract both channels by rhs
-#ifdef USE_APPLE_ACCELERATE
-      vDSP_vsub(dptr, 2, fptr, 1, dptr, 2, nFrames_);
-      vDSP_vsub(dptr+1, 2, fptr, 1, dptr+1, 2, nFrames_);
-#else
-      for ( unsigned int i=0; i<nFrames_; i++ ){
-        *dptr++ -= *fptr;
-        *dptr++ -= *fptr++;
-      }
-#endif
+      //  subtract rhs from both channels
+      vsub(dptr, 2, fptr, 1, dptr, 2, (unsigned int)nFrames_);
+      vsub(dptr+1, 2, fptr, 1, dptr+1, 2, (unsigned int)nFrames_);
     }
-
-
   }
   
-
-  inline void TonicFrames :: operator*= ( TonicFrames& f )
+  inline void TonicFrames :: operator*= ( const TonicFrames& f )
   {
-    
 #if defined(TONIC_DEBUG)
-    if ( f.frames() != nFrames_) {
+    if ( f.frames() != nFrames_ ) {
       std::ostringstream error;
-      error << "TonicFrames::operator+=: frames argument must be of equal dimensions!";
+      error << "TonicFrames::operator*=: frames argument must be of equal dimensions!";
       Tonic::error(error.str(), true);
     }
 #endif
     
-    TonicFloat *fptr = &f[0];
+    const TonicFloat *fptr = f.data_;
     TonicFloat *dptr = data_;
-
+    
     unsigned int fChannels = f.channels();
     
     if (nChannels_ == fChannels){
-      
-#ifdef USE_APPLE_ACCELERATE
-      vDSP_vmul(dptr, 1, fptr, 1, dptr, 1, size_);
-#else
-      for ( unsigned int i=0; i<size_; i++ ){
-        *dptr++ *= *fptr++;
-      }
-#endif
-      
+      vmul(dptr, 1, fptr, 1, dptr, 1, (unsigned int)size_);
     }
     else if (nChannels_ < fChannels){
-      
       //  just multiply by first channel of rhs
-#ifdef USE_APPLE_ACCELERATE
-      vDSP_vmul(dptr, 1, fptr, fChannels, dptr, 1, nFrames_);
-#else
-      for ( unsigned int i=0; i<nFrames_; i++ ){
-        *dptr++ *= *fptr++;
-        fptr++;
-      }
-#endif
-
+      vmul(dptr, 1, fptr, fChannels, dptr, 1, (unsigned int)nFrames_);
     }
     else{
-      //  multiply both channels by rhs
-#ifdef USE_APPLE_ACCELERATE
-      vDSP_vmul(dptr, 2, fptr, 1, dptr, 2, nFrames_);
-      vDSP_vmul(dptr+1, 2, fptr, 1, dptr+1, 2, nFrames_);
-#else
-      for ( unsigned int i=0; i<nFrames_; i++ ){
-        *dptr++ *= *fptr;
-        *dptr++ *= *fptr++;
-      }
-#endif
+      //  multiply rhs into both channels
+      vmul(dptr, 2, fptr, 1, dptr, 2, (unsigned int)nFrames_);
+      vmul(dptr+1, 2, fptr, 1, dptr+1, 2, (unsigned int)nFrames_);
     }
   }
-
-
-  inline void TonicFrames :: operator /= ( TonicFrames& f )
+  
+  inline void TonicFrames :: operator/= ( const TonicFrames& f )
   {
-  #if defined(TONIC_DEBUG)
+#if defined(TONIC_DEBUG)
     if ( f.frames() != nFrames_ ) {
       std::ostringstream error;
-      error << "TonicFrames::operator*=: frames argument must be of equal dimensions!";
+      error << "TonicFrames::operator/=: frames argument must be of equal dimensions!";
       Tonic::error(error.str(), true);
     }
-  #endif
+#endif
     
-    TonicFloat *fptr = &f[0];
+    const TonicFloat *fptr = f.data_;
     TonicFloat *dptr = data_;
     
     unsigned int fChannels = f.channels();
     
     if (nChannels_ == fChannels){
-      
-#ifdef USE_APPLE_ACCELERATE
-      vDSP_vdiv(fptr, 1, dptr, 1, dptr, 1, size_);
-#else
-      for ( unsigned int i=0; i<size_; i++ ){
-        *dptr++ /= *fptr++;
-      }
-#endif
-      
+      vdiv(dptr, 1, fptr, 1, dptr, 1, (unsigned int)size_);
     }
     else if (nChannels_ < fChannels){
-      
-      //  just multiply by first channel of rhs
-#ifdef USE_APPLE_ACCELERATE
-      vDSP_vdiv(fptr, fChannels, dptr, 1, dptr, 1, nFrames_);
-#else
-      for ( unsigned int i=0; i<nFrames_; i++ ){
-        *dptr++ /= *fptr++;
-        fptr++;
-      }
-#endif
-      
+      //  just divide by first channel of rhs
+      vdiv(dptr, 1, fptr, fChannels, dptr, 1, (unsigned int)nFrames_);
     }
     else{
-      //  multiply both channels by rhs
-#ifdef USE_APPLE_ACCELERATE
-      vDSP_vdiv(fptr, 2, dptr, 1, dptr, 2, nFrames_);
-      vDSP_vdiv(fptr, 2, dptr+1, 1, dptr+1, 2, nFrames_);
-#else
-      for ( unsigned int i=0; i<nFrames_; i++ ){
-        *dptr++ /= *fptr;
-        *dptr++ /= *fptr++;
-      }
-#endif
+      //  divide by rhs in both channels
+      vdiv(dptr, 2, fptr, 1, dptr, 2, (unsigned int)nFrames_);
+      vdiv(dptr+1, 2, fptr, 1, dptr+1, 2, (unsigned int)nFrames_);
     }
   }
   
+  inline void TonicFrames :: operator+= ( TonicFloat value )
+  {
+    vsadd(data_, 1, value, data_, 1, (unsigned int)size_);
+  }
+  
+  inline void TonicFrames :: operator-= ( TonicFloat value )
+  {
+    vsadd(data_, 1, -value, data_, 1, (unsigned int)size_);
+  }
+  
+  inline void TonicFrames :: operator*= ( TonicFloat value )
+  {
+    vsmul(data_, 1, value, data_, 1, (unsigned int)size_);
+  }
+  
+  inline void TonicFrames :: operator/= ( TonicFloat value )
+  {
+    vsdiv(data_, 1, value, data_, 1, (unsigned int)size_);
+  }
+  
 }
 
 #endif
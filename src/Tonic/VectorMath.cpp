@@ -0,0 +1,837 @@
+//
+//  VectorMath.cpp
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#include "VectorMath.h"
+#include "Random.h"
+#include <cstdlib>
+
+#if (defined (__x86_64__) || defined (__i386__) || defined (_M_X64) || defined (_M_IX86))
+  #define TONIC_X86
+  #include <immintrin.h>
+  #if defined (_MSC_VER)
+    #include <intrin.h>
+  #endif
+#elif (defined (__ARM_NEON) || defined (__ARM_NEON__))
+  #define TONIC_NEON
+  #include <arm_neon.h>
+#endif
+
+// Each instruction set's kernels are compiled for that instruction set regardless of the build's
+// target flags, so one binary can pick the best at runtime. MSVC allows intrinsics without this.
+#if (defined (__GNUC__) || defined (__clang__))
+  #define TONIC_TARGET(isa) __attribute__((target(isa)))
+#else
+  #define TONIC_TARGET(isa)
+#endif
+
+// avx512f implies FMA, and fusing the multiply and add in vramp would round differently from the
+// other levels. Keep every level's output identical.
+#if defined (__clang__)
+  #pragma clang fp contract(off)
+#elif defined (__GNUC__)
+  #pragma GCC optimize ("fp-contract=off")
+#endif
+
+namespace Tonic {
+
+  namespace Tonic_ {
+
+    // -- Scalar kernels, also used for the remainder after the last whole vector --
+
+    static void scalarAdd( const TonicFloat * a, const TonicFloat * b, TonicFloat * out, unsigned int length ){
+      for (unsigned int i=0; i<length; i++) out[i] = a[i] + b[i];
+    }
+
+    static void scalarSub( const TonicFloat * a, const TonicFloat * b, TonicFloat * out, unsigned int length ){
+      for (unsigned int i=0; i<length; i++) out[i] = a[i] - b[i];
+    }
+
+    static void scalarMul( const TonicFloat * a, const TonicFloat * b, TonicFloat * out, unsigned int length ){
+      for (unsigned int i=0; i<length; i++) out[i] = a[i] * b[i];
+    }
+
+    static void scalarDiv( const TonicFloat * a, const TonicFloat * b, TonicFloat * out, unsigned int length ){
+      for (unsigned int i=0; i<length; i++) out[i] = a[i] / b[i];
+    }
+
+    static void scalarSadd( const TonicFloat * a, TonicFloat value, TonicFloat * out, unsigned int length ){
+      for (unsigned int i=0; i<length; i++) out[i] = a[i] + value;
+    }
+
+    static void scalarSmul( const TonicFloat * a, TonicFloat value, TonicFloat * out, unsigned int length ){
+      for (unsigned int i=0; i<length; i++) out[i] = a[i] * value;
+    }
+
+    static void scalarSdiv( const TonicFloat * a, TonicFloat value, TonicFloat * out, unsigned int length ){
+      for (unsigned int i=0; i<length; i++) out[i] = a[i] / value;
+    }
+
+    static void scalarFill( TonicFloat value, TonicFloat * out, unsigned int length ){
+      for (unsigned int i=0; i<length; i++) out[i] = value;
+    }
+
+    static void scalarRamp( TonicFloat start, TonicFloat step, TonicFloat * out, unsigned int length ){
+      for (unsigned int i=0; i<length; i++) out[i] = start + (TonicFloat)i * step;
+    }
+
+    static void scalarAbs( const TonicFloat * a, TonicFloat * out, unsigned int length ){
+      for (unsigned int i=0; i<length; i++) out[i] = fabsf(a[i]);
+    }
+
+    static void scalarClip( const TonicFloat * a, TonicFloat low, TonicFloat high, TonicFloat * out, unsigned int length ){
+      for (unsigned int i=0; i<length; i++) out[i] = clamp(a[i], low, high);
+    }
+
+    // The index is shifted in two steps so a 1-sample table (tableBits 0) needs no special case
+    static void scalarTableLookup( const TonicFloat * table, unsigned int tableBits, const TonicUInt32 * phases, TonicFloat * out, unsigned int length ){
+      for (unsigned int i=0; i<length; i++){
+        const TonicFloat * t = table + ((phases[i] >> 1) >> (31 - tableBits));
+        TonicFloat frac = (TonicFloat)((phases[i] << tableBits) >> 9) * (1.f / 8388608.f);
+        out[i] = t[0] + frac * (t[1] - t[0]);
+      }
+    }
+
+    static void scalarNoise( TonicUInt32 * state, TonicFloat * out, unsigned int length ){
+      TonicUInt32 * s0 = state;
+      TonicUInt32 * s1 = state + TONIC_RANDOM_LANES;
+      TonicUInt32 * s2 = state + 2 * TONIC_RANDOM_LANES;
+      TonicUInt32 * s3 = state + 3 * TONIC_RANDOM_LANES;
+      for (unsigned int i=0; i<length; i += TONIC_RANDOM_LANES){
+        for (unsigned int lane=0; lane<TONIC_RANDOM_LANES; lane++){
+          TonicFloat value = randomBitsToSample(xoshiro128Plus(s0[lane], s1[lane], s2[lane], s3[lane]));
+          if (i + lane < length) out[i + lane] = value;
+        }
+      }
+    }
+
+    // -- Fast math --
+    //
+    // Polynomials from Cephes (exp2f, log2f and tanf) on a reduced range. Every level evaluates
+    // them with the same operations in the same order, so the results are identical.
+
+    static const TonicFloat exp2Coef_[6] = {
+      1.535336188319500e-4f, 1.339887440266574e-3f, 9.618437357674640e-3f,
+      5.550332471162809e-2f, 2.402264791363012e-1f, 6.931472028550421e-1f
+    };
+
+    static const TonicFloat log2Coef_[9] = {
+      7.0376836292e-2f, -1.1514610310e-1f, 1.1676998740e-1f, -1.2420140846e-1f, 1.4249322787e-1f,
+      -1.6668057665e-1f, 2.0000714765e-1f, -2.4999993993e-1f, 3.3333331174e-1f
+    };
+
+    static const TonicFloat tanCoef_[6] = {
+      9.38540185543e-3f, 3.11992232697e-3f, 2.44301354525e-2f,
+      5.34112807005e-2f, 1.33387994085e-1f, 3.33331568548e-1f
+    };
+
+    static const TonicFloat log2eMinusOne_ = 0.44269504088896340736f;
+    static const TonicFloat smallestNormal_ = 1.17549435e-38f;
+
+    // pi / 2 in three parts, so a multiple of it can be subtracted without losing precision
+    static const TonicFloat halfPi1_ = 1.5703125f;
+    static const TonicFloat halfPi2_ = 4.837512969970703125e-4f;
+    static const TonicFloat halfPi3_ = 7.54978995489188216e-8f;
+
+    static inline TonicFloat floatFromBits( TonicInt32 bits ){ TonicFloat f; memcpy(&f, &bits, sizeof(f)); return f; }
+    static inline TonicInt32 bitsFromFloat( TonicFloat f ){ TonicInt32 bits; memcpy(&bits, &f, sizeof(bits)); return bits; }
+
+    // 2^n for integral n in [-126, 127]
+    static inline TonicFloat scalarPow2( TonicFloat n ){
+      return floatFromBits(((TonicInt32)n + 127) << 23);
+    }
+
+    // Splits normal, positive a into 2^e * m with m in [sqrt(1/2), sqrt(2)), and returns e
+    static inline TonicFloat scalarFrexp( TonicFloat a, TonicFloat & m ){
+      const TonicInt32 i = bitsFromFloat(a) - 0x3F3504F3;
+      m = floatFromBits((i & 0x7FFFFF) + 0x3F3504F3);
+      return (TonicFloat)(i >> 23);
+    }
+
+    static void scalarExp2( const TonicFloat * a, TonicFloat * out, unsigned int length ){
+      for (unsigned int i=0; i<length; i++){
+        const TonicFloat x = min(max(a[i], -126.f), 126.f);
+        const TonicFloat n = floorf(x + 0.5f);
+        const TonicFloat f = x - n;
+        TonicFloat p = exp2Coef_[0];
+        for (unsigned int k=1; k<6; k++) p = p * f + exp2Coef_[k];
+        p = p * f + 1.f;
+        out[i] = p * scalarPow2(n);
+      }
+    }
+
+    static void scalarLog2( const TonicFloat * a, TonicFloat * out, unsigned int length ){
+      for (unsigned int i=0; i<length; i++){
+        TonicFloat m;
+        const TonicFloat e = scalarFrexp(max(a[i], smallestNormal_), m);
+        const TonicFloat f = m - 1.f;
+        const TonicFloat z = f * f;
+        TonicFloat p = log2Coef_[0];
+        for (unsigned int k=1; k<9; k++) p = p * f + log2Coef_[k];
+        const TonicFloat y = f * (z * p) - 0.5f * z;
+        out[i] = y * log2eMinusOne_ + f * log2eMinusOne_ + y + f + e;
+      }
+    }
+
+    // Reduced by the nearest multiple n of pi/2 to [-pi/4, pi/4], where tan(x) is -1/tan(y) if n is odd
+    static void scalarTan( const TonicFloat * a, TonicFloat * out, unsigned int length ){
+      for (unsigned int i=0; i<length; i++){
+        const TonicFloat n = floorf(a[i] * (TonicFloat)(2.0 / PI) + 0.5f);
+        const TonicFloat y = a[i] - n * halfPi1_ - n * halfPi2_ - n * halfPi3_;
+        const TonicFloat z = y * y;
+        TonicFloat p = tanCoef_[0];
+        for (unsigned int k=1; k<6; k++) p = p * z + tanCoef_[k];
+        const TonicFloat t = p * z * y + y;
+        out[i] = ((TonicInt32)n & 1) ? -1.f / t : t;
+      }
+    }
+
+    static void scalarMixStereo( const TonicFloat * in, TonicFloat * out, unsigned int length ){
+      for (unsigned int i=0; i<length; i++) out[i] = (in[2*i] + in[2*i + 1]) * 0.5f;
+    }
+
+    static void scalarDeinterleave( const TonicFloat * in, TonicFloat * left, TonicFloat * right, unsigned int length ){
+      for (unsigned int i=0; i<length; i++){
+        left[i] = in[2*i];
+        right[i] = in[2*i + 1];
+      }
+    }
+
+    static const VectorKernels_ scalarKernels_ = {
+      scalarAdd, scalarSub, scalarMul, scalarDiv, scalarSadd, scalarSmul, scalarSdiv, scalarFill, scalarRamp, scalarAbs, scalarClip, scalarTableLookup, scalarNoise,
+      scalarExp2, scalarLog2, scalarTan, scalarMixStereo, scalarDeinterleave
+    };
+
+    // -- SIMD kernels --
+
+    // Defines the fast math kernels for one instruction set, mirroring the scalar ones. Besides the
+    // float primitives they need ISA##VectorFloor, ISA##VectorPow2 and ISA##VectorFrexp (as
+    // scalarPow2 and scalarFrexp), and ISA##VectorSelectOdd(n, a, b), which picks a where the
+    // integral n is odd and b elsewhere.
+    #define TONIC_DEFINE_MATH_KERNELS(ISA, TARGET, VEC, WIDTH, LOAD, STORE, SET, ADD, SUB, MUL, DIV, MIN, MAX) \
+      \
+      TARGET static void ISA##Exp2( const TonicFloat * a, TonicFloat * out, unsigned int length ){ \
+        unsigned int i = 0; \
+        for (; i + WIDTH <= length; i += WIDTH){ \
+          const VEC x = MIN(MAX(LOAD(a + i), SET(-126.f)), SET(126.f)); \
+          const VEC n = ISA##VectorFloor(ADD(x, SET(0.5f))); \
+          const VEC f = SUB(x, n); \
+          VEC p = SET(exp2Coef_[0]); \
+          for (unsigned int k=1; k<6; k++) p = ADD(MUL(p, f), SET(exp2Coef_[k])); \
+          p = ADD(MUL(p, f), SET(1.f)); \
+          STORE(out + i, MUL(p, ISA##VectorPow2(n))); \
+        } \
+        scalarExp2(a + i, out + i, length - i); \
+      } \
+      \
+      TARGET static void ISA##Log2( const TonicFloat * a, TonicFloat * out, unsigned int length ){ \
+        const VEC log2e = SET(log2eMinusOne_); \
+        unsigned int i = 0; \
+        for (; i + WIDTH <= length; i += WIDTH){ \
+          VEC m; \
+          const VEC e = ISA##VectorFrexp(MAX(LOAD(a + i), SET(smallestNormal_)), m); \
+          const VEC f = SUB(m, SET(1.f)); \
+          const VEC z = MUL(f, f); \
+          VEC p = SET(log2Coef_[0]); \
+          for (unsigned int k=1; k<9; k++) p = ADD(MUL(p, f), SET(log2Coef_[k])); \
+          const VEC y = SUB(MUL(f, MUL(z, p)), MUL(SET(0.5f), z)); \
+          STORE(out + i, ADD(ADD(ADD(ADD(MUL(y, log2e), MUL(f, log2e)), y), f), e)); \
+        } \
+        scalarLog2(a + i, out + i, length - i); \
+      } \
+      \
+      TARGET static void ISA##Tan( const TonicFloat * a, TonicFloat * out, unsigned int length ){ \
+        unsigned int i = 0; \
+        for (; i + WIDTH <= length; i += WIDTH){ \
+          const VEC x = LOAD(a + i); \
+          const VEC n = ISA##VectorFloor(ADD(MUL(x, SET((TonicFloat)(2.0 / PI))), SET(0.5f))); \
+          const VEC y = SUB(SUB(SUB(x, MUL(n, SET(halfPi1_))), MUL(n, SET(halfPi2_))), MUL(n, SET(halfPi3_))); \
+          const VEC z = MUL(y, y); \
+          VEC p = SET(tanCoef_[0]); \
+          for (unsigned int k=1; k<6; k++) p = ADD(MUL(p, z), SET(tanCoef_[k])); \
+          const VEC t = ADD(MUL(MUL(p, z), y), y); \
+          STORE(out + i, ISA##VectorSelectOdd(n, DIV(SET(-1.f), t), t)); \
+        } \
+        scalarTan(a + i, out + i, length - i); \
+      }
+
+    // Defines the kernels for one instruction set from its vector type, width and primitives.
+    // Every kernel processes whole vectors, then hands the remaining samples to the scalar kernel.
+    // ISA##TableLookup and ISA##Noise depend on the integer and gather instructions available, so
+    // each instruction set defines them by hand before expanding this, along with the primitives
+    // TONIC_DEFINE_MATH_KERNELS needs and ISA##VectorDeinterleave(in, left, right), which splits
+    // WIDTH interleaved stereo frames into a vector of each channel.
+    #define TONIC_DEFINE_VECTOR_KERNELS(ISA, TARGET, VEC, WIDTH, LOAD, STORE, SET, ADD, SUB, MUL, DIV, MIN, MAX, ABS, INDICES) \
+      \
+      TARGET static void ISA##Add( const TonicFloat * a, const TonicFloat * b, TonicFloat * out, unsigned int length ){ \
+        unsigned int i = 0; \
+        for (; i + WIDTH <= length; i += WIDTH) STORE(out + i, ADD(LOAD(a + i), LOAD(b + i))); \
+        scalarAdd(a + i, b + i, out + i, length - i); \
+      } \
+      \
+      TARGET static void ISA##Sub( const TonicFloat * a, const TonicFloat * b, TonicFloat * out, unsigned int length ){ \
+        unsigned int i = 0; \
+        for (; i + WIDTH <= length; i += WIDTH) STORE(out + i, SUB(LOAD(a + i), LOAD(b + i))); \
+        scalarSub(a + i, b + i, out + i, length - i); \
+      } \
+      \
+      TARGET static void ISA##Mul( const TonicFloat * a, const TonicFloat * b, TonicFloat * out, unsigned int length ){ \
+        unsigned int i = 0; \
+        for (; i + WIDTH <= length; i += WIDTH) STORE(out + i, MUL(LOAD(a + i), LOAD(b + i))); \
+        scalarMul(a + i, b + i, out + i, length - i); \
+      } \
+      \
+      TARGET static void ISA##Div( const TonicFloat * a, const TonicFloat * b, TonicFloat * out, unsigned int length ){ \
+        unsigned int i = 0; \
+        for (; i + WIDTH <= length; i += WIDTH) STORE(out + i, DIV(LOAD(a + i), LOAD(b + i))); \
+        scalarDiv(a + i, b + i, out + i, length - i); \
+      } \
+      \
+      TARGET static void ISA##Sadd( const TonicFloat * a, TonicFloat value, TonicFloat * out, unsigned int length ){ \
+        const VEC v = SET(value); \
+        unsigned int i = 0; \
+        for (; i + WIDTH <= length; i += WIDTH) STORE(out + i, ADD(LOAD(a + i), v)); \
+        scalarSadd(a + i, value, out + i, length - i); \
+      } \
+      \
+      TARGET static void ISA##Smul( const TonicFloat * a, TonicFloat value, TonicFloat * out, unsigned int length ){ \
+        const VEC v = SET(value); \
+        unsigned int i = 0; \
+        for (; i + WIDTH <= length; i += WIDTH) STORE(out + i, MUL(LOAD(a + i), v)); \
+        scalarSmul(a + i, value, out + i, length - i); \
+      } \
+      \
+      TARGET static void ISA##Sdiv( const TonicFloat * a, TonicFloat value, TonicFloat * out, unsigned int length ){ \
+        const VEC v = SET(value); \
+        unsigned int i = 0; \
+        for (; i + WIDTH <= length; i += WIDTH) STORE(out + i, DIV(LOAD(a + i), v)); \
+        scalarSdiv(a + i, value, out + i, length - i); \
+      } \
+      \
+      TARGET static void ISA##Fill( TonicFloat value, TonicFloat * out, unsigned int length ){ \
+        const VEC v = SET(value); \
+        unsigned int i = 0; \
+        for (; i + WIDTH <= length; i += WIDTH) STORE(out + i, v); \
+        scalarFill(value, out + i, length - i); \
+      } \
+      \
+      TARGET static void ISA##Ramp( TonicFloat start, TonicFloat step, TonicFloat * out, unsigned int length ){ \
+        const VEC vstart = SET(start); \
+        const VEC vstep = SET(step); \
+        const VEC width = SET((TonicFloat)WIDTH); \
+        VEC index = INDICES(); \
+        unsigned int i = 0; \
+        for (; i + WIDTH <= length; i += WIDTH){ \
+          STORE(out + i, ADD(vstart, MUL(index, vstep))); \
+          index = ADD(index, width); \
+        } \
+        for (; i<length; i++) out[i] = start + (TonicFloat)i * step; \
+      } \
+      \
+      TARGET static void ISA##Abs( const TonicFloat * a, TonicFloat * out, unsigned int length ){ \
+        unsigned int i = 0; \
+        for (; i + WIDTH <= length; i += WIDTH) STORE(out + i, ABS(LOAD(a + i))); \
+        scalarAbs(a + i, out + i, length - i); \
+      } \
+      \
+      TARGET static void ISA##Clip( const TonicFloat * a, TonicFloat low, TonicFloat high, TonicFloat * out, unsigned int length ){ \
+        const VEC vlow = SET(low); \
+        const VEC vhigh = SET(high); \
+        unsigned int i = 0; \
+        for (; i + WIDTH <= length; i += WIDTH) STORE(out + i, MIN(MAX(LOAD(a + i), vlow), vhigh)); \
+        scalarClip(a + i, low, high, out + i, length - i); \
+      } \
+      \
+      TARGET static void ISA##MixStereo( const TonicFloat * in, TonicFloat * out, unsigned int length ){ \
+        const VEC half = SET(0.5f); \
+        unsigned int i = 0; \
+        for (; i + WIDTH <= length; i += WIDTH){ \
+          VEC left, right; \
+          ISA##VectorDeinterleave(in + 2*i, left, right); \
+          STORE(out + i, MUL(ADD(left, right), half)); \
+        } \
+        scalarMixStereo(in + 2*i, out + i, length - i); \
+      } \
+      \
+      TARGET static void ISA##Deinterleave( const TonicFloat * in, TonicFloat * left, TonicFloat * right, unsigned int length ){ \
+        unsigned int i = 0; \
+        for (; i + WIDTH <= length; i += WIDTH){ \
+          VEC l, r; \
+          ISA##VectorDeinterleave(in + 2*i, l, r); \
+          STORE(left + i, l); \
+          STORE(right + i, r); \
+        } \
+        scalarDeinterleave(in + 2*i, left + i, right + i, length - i); \
+      } \
+      \
+      TONIC_DEFINE_MATH_KERNELS(ISA, TARGET, VEC, WIDTH, LOAD, STORE, SET, ADD, SUB, MUL, DIV, MIN, MAX) \
+      \
+      static const VectorKernels_ ISA##Kernels_ = { \
+        ISA##Add, ISA##Sub, ISA##Mul, ISA##Div, ISA##Sadd, ISA##Smul, ISA##Sdiv, ISA##Fill, ISA##Ramp, ISA##Abs, ISA##Clip, ISA##TableLookup, ISA##Noise, \
+        ISA##Exp2, ISA##Log2, ISA##Tan, ISA##MixStereo, ISA##Deinterleave \
+      };
+
+#if defined (TONIC_X86)
+
+    #define TONIC_TARGET_SSE2 TONIC_TARGET("sse2")
+    TONIC_TARGET_SSE2 static inline __m128 sse2VectorAbs( __m128 a ) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+    TONIC_TARGET_SSE2 static inline __m128 sse2VectorIndices() { return _mm_setr_ps(0, 1, 2, 3); }
+
+    // SSE2 has no floor: truncate, then step down where that rounded up. Exact for |a| < 2^31.
+    TONIC_TARGET_SSE2 static inline __m128 sse2VectorFloor( __m128 a ){
+      const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+      return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.f)));
+    }
+
+    TONIC_TARGET_SSE2 static inline __m128 sse2VectorPow2( __m128 n ){
+      return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(n), _mm_set1_epi32(127)), 23));
+    }
+
+    TONIC_TARGET_SSE2 static inline __m128 sse2VectorFrexp( __m128 a, __m128 & m ){
+      const __m128i i = _mm_sub_epi32(_mm_castps_si128(a), _mm_set1_epi32(0x3F3504F3));
+      m = _mm_castsi128_ps(_mm_add_epi32(_mm_and_si128(i, _mm_set1_epi32(0x7FFFFF)), _mm_set1_epi32(0x3F3504F3)));
+      return _mm_cvtepi32_ps(_mm_srai_epi32(i, 23));
+    }
+
+    TONIC_TARGET_SSE2 static inline __m128 sse2VectorSelectOdd( __m128 n, __m128 a, __m128 b ){
+      const __m128 odd = _mm_castsi128_ps(_mm_srai_epi32(_mm_slli_epi32(_mm_cvttps_epi32(n), 31), 31));
+      return _mm_or_ps(_mm_and_ps(odd, a), _mm_andnot_ps(odd, b));
+    }
+
+    TONIC_TARGET_SSE2 static inline void sse2VectorDeinterleave( const TonicFloat * in, __m128 & left, __m128 & right ){
+      const __m128 a = _mm_loadu_ps(in);
+      const __m128 b = _mm_loadu_ps(in + 4);
+      left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0));
+      right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1));
+    }
+
+    // SSE2 has no gather, but the index and fraction math and the interpolation are still done 4 wide
+    TONIC_TARGET_SSE2 static void sse2TableLookup( const TonicFloat * table, unsigned int tableBits, const TonicUInt32 * phases, TonicFloat * out, unsigned int length ){
+      const __m128i indexShift = _mm_cvtsi32_si128(31 - tableBits);
+      const __m128i fracShift = _mm_cvtsi32_si128(tableBits);
+      const __m128 fracScale = _mm_set1_ps(1.f / 8388608.f);
+      unsigned int i = 0;
+      for (; i + 4 <= length; i += 4){
+        const __m128i phase = _mm_loadu_si128((const __m128i*)(phases + i));
+        const __m128 frac = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(_mm_sll_epi32(phase, fracShift), 9)), fracScale);
+        TonicInt32 index[4];
+        _mm_storeu_si128((__m128i*)index, _mm_srl_epi32(_mm_srli_epi32(phase, 1), indexShift));
+        const __m128 y0 = _mm_setr_ps(table[index[0]], table[index[1]], table[index[2]], table[index[3]]);
+        const __m128 y1 = _mm_setr_ps(table[index[0] + 1], table[index[1] + 1], table[index[2] + 1], table[index[3] + 1]);
+        _mm_storeu_ps(out + i, _mm_add_ps(y0, _mm_mul_ps(frac, _mm_sub_ps(y1, y0))));
+      }
+      scalarTableLookup(table, tableBits, phases + i, out + i, length - i);
+    }
+
+    // One xoshiro128+ step of 4 lanes, as samples in [-1, 1)
+    TONIC_TARGET_SSE2 static inline __m128 sse2NoiseStep( __m128i & s0, __m128i & s1, __m128i & s2, __m128i & s3 ){
+      const __m128i result = _mm_add_epi32(s0, s3);
+      const __m128i t = _mm_slli_epi32(s1, 9);
+      s2 = _mm_xor_si128(s2, s0);
+      s3 = _mm_xor_si128(s3, s1);
+      s1 = _mm_xor_si128(s1, s2);
+      s0 = _mm_xor_si128(s0, s3);
+      s2 = _mm_xor_si128(s2, t);
+      s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+      return _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(result, 8)), _mm_set1_ps(1.f / 8388608.f)), _mm_set1_ps(1.f));
+    }
+
+    // The 8 lanes are two halves of 4
+    TONIC_TARGET_SSE2 static void sse2Noise( TonicUInt32 * state, TonicFloat * out, unsigned int length ){
+      __m128i * s = (__m128i*)state;
+      __m128i a0 = _mm_loadu_si128(s), a1 = _mm_loadu_si128(s + 2), a2 = _mm_loadu_si128(s + 4), a3 = _mm_loadu_si128(s + 6);
+      __m128i b0 = _mm_loadu_si128(s + 1), b1 = _mm_loadu_si128(s + 3), b2 = _mm_loadu_si128(s + 5), b3 = _mm_loadu_si128(s + 7);
+      unsigned int i = 0;
+      for (; i + 8 <= length; i += 8){
+        _mm_storeu_ps(out + i, sse2NoiseStep(a0, a1, a2, a3));
+        _mm_storeu_ps(out + i + 4, sse2NoiseStep(b0, b1, b2, b3));
+      }
+      if (i < length){
+        TonicFloat group[8];
+        _mm_storeu_ps(group, sse2NoiseStep(a0, a1, a2, a3));
+        _mm_storeu_ps(group + 4, sse2NoiseStep(b0, b1, b2, b3));
+        memcpy(out + i, group, (length - i) * sizeof(TonicFloat));
+      }
+      _mm_storeu_si128(s, a0); _mm_storeu_si128(s + 2, a1); _mm_storeu_si128(s + 4, a2); _mm_storeu_si128(s + 6, a3);
+      _mm_storeu_si128(s + 1, b0); _mm_storeu_si128(s + 3, b1); _mm_storeu_si128(s + 5, b2); _mm_storeu_si128(s + 7, b3);
+    }
+
+    TONIC_DEFINE_VECTOR_KERNELS(sse2, TONIC_TARGET_SSE2, __m128, 4, _mm_loadu_ps, _mm_storeu_ps, _mm_set1_ps,
+                                _mm_add_ps, _mm_sub_ps, _mm_mul_ps, _mm_div_ps, _mm_min_ps, _mm_max_ps, sse2VectorAbs, sse2VectorIndices)
+
+    // AVX2 machines all have AVX; only 256-bit float operations are needed. FMA is not used,
+    // so results are identical to the other levels.
+    #define TONIC_TARGET_AVX2 TONIC_TARGET("avx2")
+    TONIC_TARGET_AVX2 static inline __m256 avx2VectorAbs( __m256 a ) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+    TONIC_TARGET_AVX2 static inline __m256 avx2VectorIndices() { return _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7); }
+    TONIC_TARGET_AVX2 static inline __m256 avx2VectorFloor( __m256 a ) { return _mm256_floor_ps(a); }
+
+    TONIC_TARGET_AVX2 static inline __m256 avx2VectorPow2( __m256 n ){
+      return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(n), _mm256_set1_epi32(127)), 23));
+    }
+
+    TONIC_TARGET_AVX2 static inline __m256 avx2VectorFrexp( __m256 a, __m256 & m ){
+      const __m256i i = _mm256_sub_epi32(_mm256_castps_si256(a), _mm256_set1_epi32(0x3F3504F3));
+      m = _mm256_castsi256_ps(_mm256_add_epi32(_mm256_and_si256(i, _mm256_set1_epi32(0x7FFFFF)), _mm256_set1_epi32(0x3F3504F3)));
+      return _mm256_cvtepi32_ps(_mm256_srai_epi32(i, 23));
+    }
+
+    // blendv only looks at the sign bit, so the low bit of n is shifted there
+    TONIC_TARGET_AVX2 static inline __m256 avx2VectorSelectOdd( __m256 n, __m256 a, __m256 b ){
+      return _mm256_blendv_ps(b, a, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvttps_epi32(n), 31)));
+    }
+
+    // The shuffles work within 128-bit halves, leaving the 64-bit pairs to be put back in order
+    TONIC_TARGET_AVX2 static inline void avx2VectorDeinterleave( const TonicFloat * in, __m256 & left, __m256 & right ){
+      const __m256 a = _mm256_loadu_ps(in);
+      const __m256 b = _mm256_loadu_ps(in + 8);
+      left = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0))), _MM_SHUFFLE(3,1,2,0)));
+      right = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1))), _MM_SHUFFLE(3,1,2,0)));
+    }
+
+    TONIC_TARGET_AVX2 static void avx2TableLookup( const TonicFloat * table, unsigned int tableBits, const TonicUInt32 * phases, TonicFloat * out, unsigned int length ){
+      const __m128i indexShift = _mm_cvtsi32_si128(31 - tableBits);
+      const __m128i fracShift = _mm_cvtsi32_si128(tableBits);
+      const __m256 fracScale = _mm256_set1_ps(1.f / 8388608.f);
+      unsigned int i = 0;
+      for (; i + 8 <= length; i += 8){
+        const __m256i phase = _mm256_loadu_si256((const __m256i*)(phases + i));
+        const __m256 frac = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(_mm256_sll_epi32(phase, fracShift), 9)), fracScale);
+        const __m256i index = _mm256_srl_epi32(_mm256_srli_epi32(phase, 1), indexShift);
+        const __m256 y0 = _mm256_i32gather_ps(table, index, 4);
+        const __m256 y1 = _mm256_i32gather_ps(table + 1, index, 4);
+        _mm256_storeu_ps(out + i, _mm256_add_ps(y0, _mm256_mul_ps(frac, _mm256_sub_ps(y1, y0))));
+      }
+      scalarTableLookup(table, tableBits, phases + i, out + i, length - i);
+    }
+
+    // The 8 lanes are exactly one vector
+    TONIC_TARGET_AVX2 static void avx2Noise( TonicUInt32 * state, TonicFloat * out, unsigned int length ){
+      __m256i * s = (__m256i*)state;
+      __m256i s0 = _mm256_loadu_si256(s), s1 = _mm256_loadu_si256(s + 1), s2 = _mm256_loadu_si256(s + 2), s3 = _mm256_loadu_si256(s + 3);
+      const __m256 scale = _mm256_set1_ps(1.f / 8388608.f);
+      const __m256 one = _mm256_set1_ps(1.f);
+      for (unsigned int i=0; i<length; i += 8){
+        const __m256i result = _mm256_add_epi32(s0, s3);
+        const __m256i t = _mm256_slli_epi32(s1, 9);
+        s2 = _mm256_xor_si256(s2, s0);
+        s3 = _mm256_xor_si256(s3, s1);
+        s1 = _mm256_xor_si256(s1, s2);
+        s0 = _mm256_xor_si256(s0, s3);
+        s2 = _mm256_xor_si256(s2, t);
+        s3 = _mm256_or_si256(_mm256_slli_epi32(s3, 11), _mm256_srli_epi32(s3, 21));
+        const __m256 value = _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(result, 8)), scale), one);
+        if (i + 8 <= length){
+          _mm256_storeu_ps(out + i, value);
+        }
+        else{
+          TonicFloat group[8];
+          _mm256_storeu_ps(group, value);
+          memcpy(out + i, group, (length - i) * sizeof(TonicFloat));
+        }
+      }
+      _mm256_storeu_si256(s, s0); _mm256_storeu_si256(s + 1, s1); _mm256_storeu_si256(s + 2, s2); _mm256_storeu_si256(s + 3, s3);
+    }
+
+    TONIC_DEFINE_VECTOR_KERNELS(avx2, TONIC_TARGET_AVX2, __m256, 8, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_set1_ps,
+                                _mm256_add_ps, _mm256_sub_ps, _mm256_mul_ps, _mm256_div_ps, _mm256_min_ps, _mm256_max_ps, avx2VectorAbs, avx2VectorIndices)
+
+    #define TONIC_TARGET_AVX512 TONIC_TARGET("avx512f")
+
+    // GCC implements the unmasked AVX-512 intrinsics as masked ones merging into an undefined vector,
+    // which -Wmaybe-uninitialized reports once inlined. The zero-masked forms with every lane
+    // selected compile to the same instructions without the warning.
+    static const __mmask16 kAvx512AllLanes = 0xFFFF;
+
+    TONIC_TARGET_AVX512 static inline __m512 avx512Min( __m512 a, __m512 b ) { return _mm512_maskz_min_ps(kAvx512AllLanes, a, b); }
+    TONIC_TARGET_AVX512 static inline __m512 avx512Max( __m512 a, __m512 b ) { return _mm512_maskz_max_ps(kAvx512AllLanes, a, b); }
+    TONIC_TARGET_AVX512 static inline __m512 avx512ToFloat( __m512i a ) { return _mm512_maskz_cvtepi32_ps(kAvx512AllLanes, a); }
+    TONIC_TARGET_AVX512 static inline __m512i avx512Truncate( __m512 a ) { return _mm512_maskz_cvttps_epi32(kAvx512AllLanes, a); }
+
+    TONIC_TARGET_AVX512 static inline __m512 avx512VectorAbs( __m512 a ) { return _mm512_abs_ps(a); }
+    TONIC_TARGET_AVX512 static inline __m512 avx512VectorIndices() { return _mm512_setr_ps(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15); }
+    TONIC_TARGET_AVX512 static inline __m512 avx512VectorFloor( __m512 a ) { return _mm512_maskz_roundscale_ps(kAvx512AllLanes, a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+
+    TONIC_TARGET_AVX512 static inline __m512 avx512VectorPow2( __m512 n ){
+      return _mm512_castsi512_ps(_mm512_maskz_slli_epi32(kAvx512AllLanes, _mm512_add_epi32(avx512Truncate(n), _mm512_set1_epi32(127)), 23));
+    }
+
+    TONIC_TARGET_AVX512 static inline __m512 avx512VectorFrexp( __m512 a, __m512 & m ){
+      const __m512i i = _mm512_sub_epi32(_mm512_castps_si512(a), _mm512_set1_epi32(0x3F3504F3));
+      m = _mm512_castsi512_ps(_mm512_add_epi32(_mm512_and_si512(i, _mm512_set1_epi32(0x7FFFFF)), _mm512_set1_epi32(0x3F3504F3)));
+      return avx512ToFloat(_mm512_maskz_srai_epi32(kAvx512AllLanes, i, 23));
+    }
+
+    TONIC_TARGET_AVX512 static inline __m512 avx512VectorSelectOdd( __m512 n, __m512 a, __m512 b ){
+      return _mm512_mask_blend_ps(_mm512_test_epi32_mask(avx512Truncate(n), _mm512_set1_epi32(1)), b, a);
+    }
+
+    TONIC_TARGET_AVX512 static inline void avx512VectorDeinterleave( const TonicFloat * in, __m512 & left, __m512 & right ){
+      const __m512 a = _mm512_loadu_ps(in);
+      const __m512 b = _mm512_loadu_ps(in + 16);
+      const __m512i even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+      left = _mm512_permutex2var_ps(a, even, b);
+      right = _mm512_permutex2var_ps(a, _mm512_add_epi32(even, _mm512_set1_epi32(1)), b);
+    }
+
+    TONIC_TARGET_AVX512 static void avx512TableLookup( const TonicFloat * table, unsigned int tableBits, const TonicUInt32 * phases, TonicFloat * out, unsigned int length ){
+      const __m128i indexShift = _mm_cvtsi32_si128(31 - tableBits);
+      const __m128i fracShift = _mm_cvtsi32_si128(tableBits);
+      const __m512 fracScale = _mm512_set1_ps(1.f / 8388608.f);
+      const __m512 zero = _mm512_setzero_ps();
+      unsigned int i = 0;
+      for (; i + 16 <= length; i += 16){
+        const __m512i phase = _mm512_loadu_si512((const void*)(phases + i));
+        const __m512i fracBits = _mm512_maskz_srli_epi32(kAvx512AllLanes, _mm512_maskz_sll_epi32(kAvx512AllLanes, phase, fracShift), 9);
+        const __m512 frac = _mm512_mul_ps(avx512ToFloat(fracBits), fracScale);
+        const __m512i index = _mm512_maskz_srl_epi32(kAvx512AllLanes, _mm512_maskz_srli_epi32(kAvx512AllLanes, phase, 1), indexShift);
+        const __m512 y0 = _mm512_mask_i32gather_ps(zero, kAvx512AllLanes, index, table, 4);
+        const __m512 y1 = _mm512_mask_i32gather_ps(zero, kAvx512AllLanes, index, table + 1, 4);
+        _mm512_storeu_ps(out + i, _mm512_add_ps(y0, _mm512_mul_ps(frac, _mm512_sub_ps(y1, y0))));
+      }
+      scalarTableLookup(table, tableBits, phases + i, out + i, length - i);
+    }
+
+    // The generator state is one AVX2 vector wide, which every AVX-512 CPU has
+    TONIC_TARGET_AVX512 static void avx512Noise( TonicUInt32 * state, TonicFloat * out, unsigned int length ){
+      avx2Noise(state, out, length);
+    }
+
+    TONIC_DEFINE_VECTOR_KERNELS(avx512, TONIC_TARGET_AVX512, __m512, 16, _mm512_loadu_ps, _mm512_storeu_ps, _mm512_set1_ps,
+                                _mm512_add_ps, _mm512_sub_ps, _mm512_mul_ps, _mm512_div_ps, avx512Min, avx512Max, avx512VectorAbs, avx512VectorIndices)
+
+#elif defined (TONIC_NEON)
+
+    static inline float32x4_t neonVectorIndices() { const float32_t i[4] = {0, 1, 2, 3}; return vld1q_f32(i); }
+
+    // Truncate, then step down where that rounded up, as for SSE2. Exact for |a| < 2^31.
+    static inline float32x4_t neonVectorFloor( float32x4_t a ){
+      const float32x4_t t = vcvtq_f32_s32(vcvtq_s32_f32(a));
+      return vsubq_f32(t, vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(t, a), vreinterpretq_u32_f32(vdupq_n_f32(1.f)))));
+    }
+
+    static inline float32x4_t neonVectorPow2( float32x4_t n ){
+      return vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127)), 23));
+    }
+
+    static inline float32x4_t neonVectorFrexp( float32x4_t a, float32x4_t & m ){
+      const int32x4_t i = vsubq_s32(vreinterpretq_s32_f32(a), vdupq_n_s32(0x3F3504F3));
+      m = vreinterpretq_f32_s32(vaddq_s32(vandq_s32(i, vdupq_n_s32(0x7FFFFF)), vdupq_n_s32(0x3F3504F3)));
+      return vcvtq_f32_s32(vshrq_n_s32(i, 23));
+    }
+
+    static inline float32x4_t neonVectorSelectOdd( float32x4_t n, float32x4_t a, float32x4_t b ){
+      return vbslq_f32(vtstq_s32(vcvtq_s32_f32(n), vdupq_n_s32(1)), a, b);
+    }
+
+    static inline void neonVectorDeinterleave( const TonicFloat * in, float32x4_t & left, float32x4_t & right ){
+      const float32x4x2_t frames = vld2q_f32(in);
+      left = frames.val[0];
+      right = frames.val[1];
+    }
+
+  #if defined (__aarch64__)
+    static inline float32x4_t neonVectorDiv( float32x4_t a, float32x4_t b ) { return vdivq_f32(a, b); }
+  #else
+    // 32-bit NEON has no division: divide lane by lane, so results match the scalar kernels exactly
+    static inline float32x4_t neonVectorDiv( float32x4_t a, float32x4_t b ){
+      float32_t x[4], y[4];
+      vst1q_f32(x, a);
+      vst1q_f32(y, b);
+      for (unsigned int i=0; i<4; i++) x[i] /= y[i];
+      return vld1q_f32(x);
+    }
+  #endif
+
+    // NEON has no gather either; shifts by a negative count shift right
+    static void neonTableLookup( const TonicFloat * table, unsigned int tableBits, const TonicUInt32 * phases, TonicFloat * out, unsigned int length ){
+      const int32x4_t indexShift = vdupq_n_s32(-(int32_t)(31 - tableBits));
+      const int32x4_t fracShift = vdupq_n_s32((int32_t)tableBits);
+      const float32x4_t fracScale = vdupq_n_f32(1.f / 8388608.f);
+      unsigned int i = 0;
+      for (; i + 4 <= length; i += 4){
+        const uint32x4_t phase = vld1q_u32(phases + i);
+        const float32x4_t frac = vmulq_f32(vcvtq_f32_u32(vshrq_n_u32(vshlq_u32(phase, fracShift), 9)), fracScale);
+        uint32_t index[4];
+        vst1q_u32(index, vshlq_u32(vshrq_n_u32(phase, 1), indexShift));
+        float32_t y[8];
+        for (unsigned int j=0; j<4; j++){
+          y[j] = table[index[j]];
+          y[j + 4] = table[index[j] + 1];
+        }
+        const float32x4_t y0 = vld1q_f32(y);
+        const float32x4_t y1 = vld1q_f32(y + 4);
+        vst1q_f32(out + i, vaddq_f32(y0, vmulq_f32(frac, vsubq_f32(y1, y0))));
+      }
+      scalarTableLookup(table, tableBits, phases + i, out + i, length - i);
+    }
+
+    static inline float32x4_t neonNoiseStep( uint32x4_t & s0, uint32x4_t & s1, uint32x4_t & s2, uint32x4_t & s3 ){
+      const uint32x4_t result = vaddq_u32(s0, s3);
+      const uint32x4_t t = vshlq_n_u32(s1, 9);
+      s2 = veorq_u32(s2, s0);
+      s3 = veorq_u32(s3, s1);
+      s1 = veorq_u32(s1, s2);
+      s0 = veorq_u32(s0, s3);
+      s2 = veorq_u32(s2, t);
+      s3 = vorrq_u32(vshlq_n_u32(s3, 11), vshrq_n_u32(s3, 21));
+      return vsubq_f32(vmulq_f32(vcvtq_f32_u32(vshrq_n_u32(result, 8)), vdupq_n_f32(1.f / 8388608.f)), vdupq_n_f32(1.f));
+    }
+
+    // The 8 lanes are two halves of 4
+    static void neonNoise( TonicUInt32 * state, TonicFloat * out, unsigned int length ){
+      uint32x4_t a0 = vld1q_u32(state), a1 = vld1q_u32(state + 8), a2 = vld1q_u32(state + 16), a3 = vld1q_u32(state + 24);
+      uint32x4_t b0 = vld1q_u32(state + 4), b1 = vld1q_u32(state + 12), b2 = vld1q_u32(state + 20), b3 = vld1q_u32(state + 28);
+      unsigned int i = 0;
+      for (; i + 8 <= length; i += 8){
+        vst1q_f32(out + i, neonNoiseStep(a0, a1, a2, a3));
+        vst1q_f32(out + i + 4, neonNoiseStep(b0, b1, b2, b3));
+      }
+      if (i < length){
+        TonicFloat group[8];
+        vst1q_f32(group, neonNoiseStep(a0, a1, a2, a3));
+        vst1q_f32(group + 4, neonNoiseStep(b0, b1, b2, b3));
+        memcpy(out + i, group, (length - i) * sizeof(TonicFloat));
+      }
+      vst1q_u32(state, a0); vst1q_u32(state + 8, a1); vst1q_u32(state + 16, a2); vst1q_u32(state + 24, a3);
+      vst1q_u32(state + 4, b0); vst1q_u32(state + 12, b1); vst1q_u32(state + 20, b2); vst1q_u32(state + 28, b3);
+    }
+
+    TONIC_DEFINE_VECTOR_KERNELS(neon, , float32x4_t, 4, vld1q_f32, vst1q_f32, vdupq_n_f32,
+                                vaddq_f32, vsubq_f32, vmulq_f32, neonVectorDiv, vminq_f32, vmaxq_f32, vabsq_f32, neonVectorIndices)
+
+#endif
+
+    // Starts out with the baseline every CPU of the architecture has, so kernels used during
+    // static initialization work. Constant-initialized, so it is valid before any constructor runs.
+    // Upgraded to the detected level before main().
+#if defined (TONIC_X86) && (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+    VectorKernels_ vectorKernels_ = { sse2Add, sse2Sub, sse2Mul, sse2Div, sse2Sadd, sse2Smul, sse2Sdiv, sse2Fill, sse2Ramp, sse2Abs, sse2Clip, sse2TableLookup, sse2Noise,
+                                      sse2Exp2, sse2Log2, sse2Tan, sse2MixStereo, sse2Deinterleave };
+    static SimdLevel currentSimdLevel_ = SIMD_SSE2;
+#elif defined (TONIC_NEON)
+    VectorKernels_ vectorKernels_ = { neonAdd, neonSub, neonMul, neonDiv, neonSadd, neonSmul, neonSdiv, neonFill, neonRamp, neonAbs, neonClip, neonTableLookup, neonNoise,
+                                      neonExp2, neonLog2, neonTan, neonMixStereo, neonDeinterleave };
+    static SimdLevel currentSimdLevel_ = SIMD_NEON;
+#else
+    VectorKernels_ vectorKernels_ = { scalarAdd, scalarSub, scalarMul, scalarDiv, scalarSadd, scalarSmul, scalarSdiv, scalarFill, scalarRamp, scalarAbs, scalarClip, scalarTableLookup, scalarNoise,
+                                      scalarExp2, scalarLog2, scalarTan, scalarMixStereo, scalarDeinterleave };
+    static SimdLevel currentSimdLevel_ = SIMD_SCALAR;
+#endif
+
+    static SimdLevel detectSimdLevel(){
+
+#if defined (TONIC_X86)
+
+  #if (defined (__GNUC__) || defined (__clang__))
+      // also checks that the OS saves the wider registers
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx512f")) return SIMD_AVX512;
+      if (__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+      if (__builtin_cpu_supports("sse2")) return SIMD_SSE2;
+  #elif defined (_MSC_VER)
+      int info[4];
+      __cpuid(info, 0);
+      int maxLeaf = info[0];
+
+      __cpuid(info, 1);
+      bool sse2 = (info[3] & (1 << 26)) != 0;
+      bool osxsave = (info[2] & (1 << 27)) != 0;
+      bool avx = (info[2] & (1 << 28)) != 0;
+      unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+
+      bool avx2 = false, avx512 = false;
+      if (maxLeaf >= 7){
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+        avx512 = (info[1] & (1 << 16)) != 0;
+      }
+
+      // the OS must save the YMM (and for AVX-512, opmask and ZMM) registers
+      if (avx512 && (xcr0 & 0xE6) == 0xE6) return SIMD_AVX512;
+      if (avx && avx2 && (xcr0 & 0x6) == 0x6) return SIMD_AVX2;
+      if (sse2) return SIMD_SSE2;
+  #endif
+      return SIMD_SCALAR;
+
+#elif defined (TONIC_NEON)
+      return SIMD_NEON;
+#else
+      return SIMD_SCALAR;
+#endif
+    }
+
+    static const VectorKernels_ * kernelsForLevel( SimdLevel level ){
+      switch (level){
+        case SIMD_SCALAR: return &scalarKernels_;
+#if defined (TONIC_X86)
+        case SIMD_SSE2: return &sse2Kernels_;
+        case SIMD_AVX2: return &avx2Kernels_;
+        case SIMD_AVX512: return &avx512Kernels_;
+#elif defined (TONIC_NEON)
+        case SIMD_NEON: return &neonKernels_;
+#endif
+        default: return NULL;
+      }
+    }
+
+    // Selects the kernels before main(), honoring TONIC_SIMD if set
+    struct SimdLevelInitializer_ {
+      SimdLevelInitializer_(){
+        setSimdLevel(detectedSimdLevel());
+        const char * forced = getenv("TONIC_SIMD");
+        if (forced){
+          for (int level = SIMD_SCALAR; level <= SIMD_NEON; level++){
+            if (strcmp(forced, simdLevelName((SimdLevel)level)) == 0){
+              setSimdLevel((SimdLevel)level);
+              return;
+            }
+          }
+          warning(string("TONIC_SIMD: unknown level ") + forced);
+        }
+      }
+    };
+
+    static SimdLevelInitializer_ simdLevelInitializer_;
+
+  }
+
+  SimdLevel simdLevel(){
+    return Tonic_::currentSimdLevel_;
+  }
+
+  SimdLevel detectedSimdLevel(){
+    static SimdLevel detected = Tonic_::detectSimdLevel();
+    return detected;
+  }
+
+  bool setSimdLevel( SimdLevel level ){
+
+    const Tonic_::VectorKernels_ * kernels = Tonic_::kernelsForLevel(level);
+
+    // levels above the detected one are not safe to run, except scalar which always is
+    if (!kernels || (level != SIMD_SCALAR && level > detectedSimdLevel())){
+      warning(string("setSimdLevel: ") + simdLevelName(level) + " is not supported on this CPU or build");
+      return false;
+    }
+
+    Tonic_::vectorKernels_ = *kernels;
+    Tonic_::currentSimdLevel_ = level;
+    return true;
+  }
+
+  const char * simdLevelName( SimdLevel level ){
+    switch (level){
+      case SIMD_SCALAR: return "scalar";
+      case SIMD_SSE2: return "sse2";
+      case SIMD_AVX2: return "avx2";
+      case SIMD_AVX512: return "avx512";
+      case SIMD_NEON: return "neon";
+    }
+    return "unknown";
+  }
+
+}
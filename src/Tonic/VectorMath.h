@@ -0,0 +1,355 @@
+//
+//  VectorMath.h
+//  Tonic
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#ifndef TONIC_VECTORMATH_H
+#define TONIC_VECTORMATH_H
+
+#include "TonicCore.h"
+
+/*
+  Block arithmetic kernels used by TonicFrames and the generators.
+
+  On Apple platforms these forward to vDSP, which does its own CPU dispatch. Elsewhere, unit-stride
+  calls go through a table of kernels selected at startup for the best instruction set the CPU
+  supports (see setSimdLevel), and strided calls use scalar loops. Strides are in samples.
+  Unlike vDSP, operands are always in natural order: vsub computes a - b and vdiv computes a / b.
+*/
+
+// Lanes of the generator state used by vnoise
+#define TONIC_RANDOM_LANES        8
+#define TONIC_RANDOM_STATE_WORDS  (4 * TONIC_RANDOM_LANES)
+
+namespace Tonic {
+
+  //! Instruction set used by the vector kernels
+  enum SimdLevel {
+    SIMD_SCALAR,
+    SIMD_SSE2,
+    SIMD_AVX2,
+    SIMD_AVX512,
+    SIMD_NEON
+  };
+
+  //! Instruction set the vector kernels currently use
+  SimdLevel simdLevel();
+
+  //! Best instruction set supported by this CPU (and this build)
+  SimdLevel detectedSimdLevel();
+
+  //! Force the vector kernels to use an instruction set, e.g. to test or benchmark the others.
+  /*!
+      Returns false, leaving the level unchanged, if this CPU or build does not support it.
+      The level can also be forced at startup with the TONIC_SIMD environment variable
+      (scalar, sse2, avx2, avx512 or neon).
+      The kernel table is overwritten entry by entry without synchronization, so call this before
+      any Synth, Mixer or OfflineRenderer starts processing, never while audio is running.
+   */
+  bool setSimdLevel( SimdLevel level );
+
+  //! Lowercase name of a level, as accepted by TONIC_SIMD
+  const char * simdLevelName( SimdLevel level );
+
+  namespace Tonic_ {
+
+    //! Unit-stride implementations of the vector kernels for one instruction set
+    struct VectorKernels_ {
+      void (*add)( const TonicFloat * a, const TonicFloat * b, TonicFloat * out, unsigned int length );
+      void (*sub)( const TonicFloat * a, const TonicFloat * b, TonicFloat * out, unsigned int length );
+      void (*mul)( const TonicFloat * a, const TonicFloat * b, TonicFloat * out, unsigned int length );
+      void (*div)( const TonicFloat * a, const TonicFloat * b, TonicFloat * out, unsigned int length );
+      void (*sadd)( const TonicFloat * a, TonicFloat value, TonicFloat * out, unsigned int length );
+      void (*smul)( const TonicFloat * a, TonicFloat value, TonicFloat * out, unsigned int length );
+      void (*sdiv)( const TonicFloat * a, TonicFloat value, TonicFloat * out, unsigned int length );
+      void (*fill)( TonicFloat value, TonicFloat * out, unsigned int length );
+      void (*ramp)( TonicFloat start, TonicFloat step, TonicFloat * out, unsigned int length );
+      void (*abs)( const TonicFloat * a, TonicFloat * out, unsigned int length );
+      void (*clip)( const TonicFloat * a, TonicFloat low, TonicFloat high, TonicFloat * out, unsigned int length );
+      void (*tableLookup)( const TonicFloat * table, unsigned int tableBits, const TonicUInt32 * phases, TonicFloat * out, unsigned int length );
+      void (*noise)( TonicUInt32 * state, TonicFloat * out, unsigned int length );
+      void (*exp2)( const TonicFloat * a, TonicFloat * out, unsigned int length );
+      void (*log2)( const TonicFloat * a, TonicFloat * out, unsigned int length );
+      void (*tan)( const TonicFloat * a, TonicFloat * out, unsigned int length );
+      void (*mixStereo)( const TonicFloat * in, TonicFloat * out, unsigned int length );
+      void (*deinterleave)( const TonicFloat * in, TonicFloat * left, TonicFloat * right, unsigned int length );
+    };
+
+    //! The kernels for the current SimdLevel
+    extern VectorKernels_ vectorKernels_;
+
+  }
+
+  // -- Kernels --
+
+  //! out = a + b
+  inline static void vadd( const TonicFloat * a, unsigned int aStride, const TonicFloat * b, unsigned int bStride, TonicFloat * out, unsigned int outStride, unsigned int length ){
+#ifdef USE_APPLE_ACCELERATE
+    vDSP_vadd(a, aStride, b, bStride, out, outStride, length);
+#else
+    if (aStride == 1 && bStride == 1 && outStride == 1){
+      Tonic_::vectorKernels_.add(a, b, out, length);
+      return;
+    }
+    for (unsigned int i=0; i<length; i++){
+      out[i*outStride] = a[i*aStride] + b[i*bStride];
+    }
+#endif
+  }
+
+  //! out = a - b
+  inline static void vsub( const TonicFloat * a, unsigned int aStride, const TonicFloat * b, unsigned int bStride, TonicFloat * out, unsigned int outStride, unsigned int length ){
+#ifdef USE_APPLE_ACCELERATE
+    vDSP_vsub(b, bStride, a, aStride, out, outStride, length);
+#else
+    if (aStride == 1 && bStride == 1 && outStride == 1){
+      Tonic_::vectorKernels_.sub(a, b, out, length);
+      return;
+    }
+    for (unsigned int i=0; i<length; i++){
+      out[i*outStride] = a[i*aStride] - b[i*bStride];
+    }
+#endif
+  }
+
+  //! out = a * b
+  inline static void vmul( const TonicFloat * a, unsigned int aStride, const TonicFloat * b, unsigned int bStride, TonicFloat * out, unsigned int outStride, unsigned int length ){
+#ifdef USE_APPLE_ACCELERATE
+    vDSP_vmul(a, aStride, b, bStride, out, outStride, length);
+#else
+    if (aStride == 1 && bStride == 1 && outStride == 1){
+      Tonic_::vectorKernels_.mul(a, b, out, length);
+      return;
+    }
+    for (unsigned int i=0; i<length; i++){
+      out[i*outStride] = a[i*aStride] * b[i*bStride];
+    }
+#endif
+  }
+
+  //! out = a / b
+  inline static void vdiv( const TonicFloat * a, unsigned int aStride, const TonicFloat * b, unsigned int bStride, TonicFloat * out, unsigned int outStride, unsigned int length ){
+#ifdef USE_APPLE_ACCELERATE
+    vDSP_vdiv(b, bStride, a, aStride, out, outStride, length);
+#else
+    if (aStride == 1 && bStride == 1 && outStride == 1){
+      Tonic_::vectorKernels_.div(a, b, out, length);
+      return;
+    }
+    for (unsigned int i=0; i<length; i++){
+      out[i*outStride] = a[i*aStride] / b[i*bStride];
+    }
+#endif
+  }
+
+  //! out = a + value
+  inline static void vsadd( const TonicFloat * a, unsigned int aStride, TonicFloat value, TonicFloat * out, unsigned int outStride, unsigned int length ){
+#ifdef USE_APPLE_ACCELERATE
+    vDSP_vsadd(a, aStride, &value, out, outStride, length);
+#else
+    if (aStride == 1 && outStride == 1){
+      Tonic_::vectorKernels_.sadd(a, value, out, length);
+      return;
+    }
+    for (unsigned int i=0; i<length; i++){
+      out[i*outStride] = a[i*aStride] + value;
+    }
+#endif
+  }
+
+  //! out = a * value
+  inline static void vsmul( const TonicFloat * a, unsigned int aStride, TonicFloat value, TonicFloat * out, unsigned int outStride, unsigned int length ){
+#ifdef USE_APPLE_ACCELERATE
+    vDSP_vsmul(a, aStride, &value, out, outStride, length);
+#else
+    if (aStride == 1 && outStride == 1){
+      Tonic_::vectorKernels_.smul(a, value, out, length);
+      return;
+    }
+    for (unsigned int i=0; i<length; i++){
+      out[i*outStride] = a[i*aStride] * value;
+    }
+#endif
+  }
+
+  //! out = a / value
+  inline static void vsdiv( const TonicFloat * a, unsigned int aStride, TonicFloat value, TonicFloat * out, unsigned int outStride, unsigned int length ){
+#ifdef USE_APPLE_ACCELERATE
+    vDSP_vsdiv(a, aStride, &value, out, outStride, length);
+#else
+    if (aStride == 1 && outStride == 1){
+      Tonic_::vectorKernels_.sdiv(a, value, out, length);
+      return;
+    }
+    for (unsigned int i=0; i<length; i++){
+      out[i*outStride] = a[i*aStride] / value;
+    }
+#endif
+  }
+
+  //! out = value
+  inline static void vfill( TonicFloat value, TonicFloat * out, unsigned int outStride, unsigned int length ){
+#ifdef USE_APPLE_ACCELERATE
+    vDSP_vfill(&value, out, outStride, length);
+#else
+    if (outStride == 1){
+      Tonic_::vectorKernels_.fill(value, out, length);
+      return;
+    }
+    for (unsigned int i=0; i<length; i++){
+      out[i*outStride] = value;
+    }
+#endif
+  }
+
+  //! out[i] = start + i * step
+  inline static void vramp( TonicFloat start, TonicFloat step, TonicFloat * out, unsigned int outStride, unsigned int length ){
+#ifdef USE_APPLE_ACCELERATE
+    vDSP_vramp(&start, &step, out, outStride, length);
+#else
+    if (outStride == 1){
+      Tonic_::vectorKernels_.ramp(start, step, out, length);
+      return;
+    }
+    for (unsigned int i=0; i<length; i++){
+      out[i*outStride] = start + (TonicFloat)i * step;
+    }
+#endif
+  }
+
+  //! out = |a|
+  inline static void vabs( const TonicFloat * a, unsigned int aStride, TonicFloat * out, unsigned int outStride, unsigned int length ){
+#ifdef USE_APPLE_ACCELERATE
+    vDSP_vabs(a, aStride, out, outStride, length);
+#else
+    if (aStride == 1 && outStride == 1){
+      Tonic_::vectorKernels_.abs(a, out, length);
+      return;
+    }
+    for (unsigned int i=0; i<length; i++){
+      out[i*outStride] = fabsf(a[i*aStride]);
+    }
+#endif
+  }
+
+  //! out = a clamped to [low, high]
+  inline static void vclip( const TonicFloat * a, unsigned int aStride, TonicFloat low, TonicFloat high, TonicFloat * out, unsigned int outStride, unsigned int length ){
+#ifdef USE_APPLE_ACCELERATE
+    vDSP_vclip(a, aStride, &low, &high, out, outStride, length);
+#else
+    if (aStride == 1 && outStride == 1){
+      Tonic_::vectorKernels_.clip(a, low, high, out, length);
+      return;
+    }
+    for (unsigned int i=0; i<length; i++){
+      out[i*outStride] = clamp(a[i*aStride], low, high);
+    }
+#endif
+  }
+
+  //! out = the average of the two channels of length interleaved stereo frames
+  inline static void vmixstereo( const TonicFloat * in, TonicFloat * out, unsigned int length ){
+#ifdef USE_APPLE_ACCELERATE
+    const TonicFloat half = 0.5f;
+    vDSP_vadd(in, 2, in + 1, 2, out, 1, length);
+    vDSP_vsmul(out, 1, &half, out, 1, length);
+#else
+    Tonic_::vectorKernels_.mixStereo(in, out, length);
+#endif
+  }
+
+  //! Split length interleaved stereo frames into left and right
+  inline static void vdeinterleave( const TonicFloat * in, TonicFloat * left, TonicFloat * right, unsigned int length ){
+#ifdef USE_APPLE_ACCELERATE
+    DSPSplitComplex split = { left, right };
+    vDSP_ctoz((const DSPComplex*)in, 2, &split, 1, length);
+#else
+    Tonic_::vectorKernels_.deinterleave(in, left, right, length);
+#endif
+  }
+
+  //! Wavetable lookup with linear interpolation, for each of length 32-bit fixed-point phases.
+  /*!
+      A phase of 2^32 is one pass through the first 2^tableBits samples of table, which must be
+      followed by one guard sample (usually a copy of the first). The top tableBits bits of a phase
+      select the sample and the next 23 bits are the interpolation fraction.
+      Always uses the kernel table, including on Apple platforms, since vDSP has no equivalent.
+   */
+  inline static void vtablelookup( const TonicFloat * table, unsigned int tableBits, const TonicUInt32 * phases, TonicFloat * out, unsigned int length ){
+    Tonic_::vectorKernels_.tableLookup(table, tableBits, phases, out, length);
+  }
+
+  //! Uniform random samples in [-1, 1) from TONIC_RANDOM_LANES independent xoshiro128+ generators.
+  /*!
+      state holds word k of lane l at state[k * TONIC_RANDOM_LANES + l]. Sample i comes from lane
+      i % TONIC_RANDOM_LANES, and a partial group at the end still advances every lane, so the output
+      is identical for every SimdLevel. Usually called through Random::fill.
+   */
+  inline static void vnoise( TonicUInt32 * state, TonicFloat * out, unsigned int length ){
+    Tonic_::vectorKernels_.noise(state, out, length);
+  }
+
+  // -- Fast math --
+  /*
+    Polynomial approximations of bounded error, evaluated a vector at a time. They always use the
+    kernel table, including on Apple platforms, so results are identical everywhere. All of them
+    work in place (out == a).
+  */
+
+  //! out = 2^a, within 2e-7 relative error. a is clamped to [-126, 126].
+  inline static void vexp2( const TonicFloat * a, TonicFloat * out, unsigned int length ){
+    Tonic_::vectorKernels_.exp2(a, out, length);
+  }
+
+  //! out = log2(a), within 1.5 ulp. a below the smallest normal float (including 0 and negative values) gives -126.
+  inline static void vlog2( const TonicFloat * a, TonicFloat * out, unsigned int length ){
+    Tonic_::vectorKernels_.log2(a, out, length);
+  }
+
+  //! out = tan(a), within 3 ulp for |a| < 100 and 2e-6 relative error for |a| < 8192. Larger arguments are not supported.
+  inline static void vtan( const TonicFloat * a, TonicFloat * out, unsigned int length ){
+    Tonic_::vectorKernels_.tan(a, out, length);
+  }
+
+  //! out = a^b for positive a, as 2^(b * log2(a)). out may be a but not b.
+  inline static void vpow( const TonicFloat * a, const TonicFloat * b, TonicFloat * out, unsigned int length ){
+    vlog2(a, out, length);
+    vmul(out, 1, b, 1, out, 1, length);
+    vexp2(out, out, length);
+  }
+
+  //! Block version of mtof: midi note numbers to Hz
+  inline static void vmtof( const TonicFloat * a, TonicFloat * out, unsigned int length ){
+    // 440 * 2^((a - 69) / 12) = 2^(a / 12 + log2(440) - 69 / 12)
+    vsmul(a, 1, 1.f / 12.f, out, 1, length);
+    vsadd(out, 1, 3.0313597135f, out, 1, length);
+    vexp2(out, out, length);
+  }
+
+  //! Block version of ftom: Hz to midi note numbers
+  inline static void vftom( const TonicFloat * a, TonicFloat * out, unsigned int length ){
+    // 12 * log2(a / 440) + 69 = 12 * log2(a) + 69 - 12 * log2(440)
+    vlog2(a, out, length);
+    vsmul(out, 1, 12.f, out, 1, length);
+    vsadd(out, 1, -36.376316562f, out, 1, length);
+  }
+
+  //! Block version of dBToLin
+  inline static void vdbtolin( const TonicFloat * a, TonicFloat * out, unsigned int length ){
+    // 10^(a / 20) = 2^(a * log2(10) / 20)
+    vsmul(a, 1, 0.16609640474f, out, 1, length);
+    vexp2(out, out, length);
+  }
+
+  //! Block version of linTodB. Silence gives about -758.5 dB rather than -inf.
+  inline static void vlintodb( const TonicFloat * a, TonicFloat * out, unsigned int length ){
+    // 20 * log10(a) = 20 / log2(10) * log2(a)
+    vlog2(a, out, length);
+    vsmul(out, 1, 6.0205999133f, out, 1, length);
+  }
+
+}
+
+#endif
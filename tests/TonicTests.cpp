@@ -0,0 +1,226 @@
+//
+//  TonicTests.cpp
+//  Tonic
+//
+//  Standalone checks of graph compilation and block processing. Prints each failed check
+//  and exits with a non-zero status if any failed.
+//
+//  Usage: TonicTests
+//
+// See LICENSE.txt for license and usage information.
+//
+
+#include "Tonic.h"
+#include <cstdio>
+#include <cstring>
+
+using namespace Tonic;
+
+namespace {
+
+  int failures = 0;
+
+  void check( bool condition, const char * description ){
+    if (!condition){
+      printf("FAILED: %s\n", description);
+      failures++;
+    }
+  }
+
+  bool isScheduled( Generator node, Generator root ){
+    Tonic_::GraphSchedule_ schedule;
+    schedule.compile(root.rawGenerator());
+    return schedule.contains(node.rawGenerator());
+  }
+
+  void testMultiplierScheduling(){
+
+    SineWave osc = SineWave().freq(440);
+
+    // a fixed gain never silences the product, so the oscillator gets a slot
+    check(isScheduled(osc, osc * 0.5f), "osc * 0.5 schedules the oscillator");
+
+    // without gating, every input is computed whatever the other inputs output
+    check(isScheduled(osc, osc * ADSR()), "osc * envelope schedules the oscillator unless gated");
+
+    // a fixed zero always silences a gated product, so the oscillator is only computed on demand
+    check(!isScheduled(osc, (osc * 0.f).gateInputs()), "gated osc * 0 doesn't schedule the oscillator");
+
+    // a gain driven by a control may reach zero, and gates the oscillator like an envelope does
+    check(!isScheduled(osc, (osc * ControlParameter()).gateInputs()), "gated osc * control doesn't schedule the oscillator");
+    check(!isScheduled(osc, (osc * ADSR()).gateInputs()), "gated osc * envelope doesn't schedule the oscillator");
+  }
+
+  void testScheduleStaleness(){
+
+    Adder sum;
+    sum.input(SineWave().freq(220));
+    Generator root = sum * 0.5f;
+
+    Tonic_::GraphSchedule_ schedule;
+    schedule.compile(root.rawGenerator());
+
+    // building or copying unrelated generators doesn't touch this graph
+    Synth other;
+    other.setOutputGen(SineWave().freq(440) * 0.25f);
+    Generator copy = root;
+    copy = SawtoothWave().freq(110);
+    check(schedule.isCurrent(), "unrelated graphs and handle copies keep a schedule current");
+
+    sum.input(SineWave().freq(330));
+    check(!schedule.isCurrent(), "connecting an input to a scheduled generator makes the schedule stale");
+
+    schedule.compile(root.rawGenerator());
+    check(schedule.isCurrent(), "recompiling makes the schedule current again");
+  }
+
+  void testScratchDepth(){
+
+    // nested borrows through filters, effects and a gated product, ticked recursively as on the first block
+    ControlParameter gain;
+    Generator osc = SawtoothWave().freq(110 + SineWave().freq(2) * 10) >> LPF24().cutoff(800 + SineWave().freq(1) * 400);
+    Generator root = ((osc * gain).gateInputs() >> SVFLPF().cutoff(1200) >> BasicDelay(0.1f)) + RectWave().freq(55);
+
+    Tonic_::ScratchStack_ scratch(Tonic_::GraphSchedule_::scratchDepth(root.rawGenerator()));
+    unsigned int capacity = scratch.capacity();
+
+    Tonic_::SynthesisContext_ context;
+    context.scratch = &scratch;
+    TonicFrames frames(synthesisBlockSize(), 2);
+    for (unsigned int i=0; i<4; i++){
+      root.tick(frames, context);
+      context.forceNewOutput = true;
+    }
+
+    check(scratch.capacity() == capacity, "scratch stack sized by scratchDepth() doesn't grow while ticking");
+  }
+
+  void testDelayLineRateChange(){
+
+    DelayLine line;
+    line.setSampleRate(44100);
+    line.initialize(0.5f, 1);
+    const TonicFloat * storage = &line[0];
+
+    // storage is reserved for the highest rate, so switching rates only resizes within it
+    line.setSampleRate(96000);
+    check(line.frames() == 48000, "DelayLine::setSampleRate resizes for the new rate");
+    check(&line[0] == storage, "DelayLine::setSampleRate doesn't reallocate up to maxSampleRate()");
+  }
+
+  const ProfileNode * findProfileNode( const ProfileNode & node, const string & name ){
+    if (node.name == name) return &node;
+    for (unsigned int i=0; i<node.children.size(); i++){
+      const ProfileNode * found = findProfileNode(node.children[i], name);
+      if (found) return found;
+    }
+    return NULL;
+  }
+
+  void testProfilerScheduled(){
+
+    Synth synth;
+    synth.setOutputGen(SawtoothWave().freq(110) >> LPF12().cutoff(800));
+    synth.setProfilingEnabled(true);
+
+    float buffer[64 * 2];
+    for (unsigned int i=0; i<16; i++){
+      synth.fillBufferOfFloats(buffer, 64, 2);
+    }
+
+    // all but the first block run from the schedule, and keep the graph's nesting in the report
+    ProfileNode profile = synth.getProfile();
+    const ProfileNode * filter = findProfileNode(profile, "LPF12");
+    check(filter && filter->calls == 16 * 64 / synthesisBlockSize(), "scheduled blocks are profiled");
+    check(filter && findProfileNode(*filter, "AngularWave"), "scheduled generators are reported under their consumer");
+  }
+
+  void testSlidingMaximumPush(){
+
+    TonicFloat input[40], ticked[40], pushed[40];
+    for (int i=0; i<40; i++){
+      input[i] = (TonicFloat)((i * 7) % 13);
+    }
+
+    // pushing samples without maxima leaves the same window as ticking them
+    SlidingMaximum reference, skipping;
+    reference.initialize(8);
+    skipping.initialize(8);
+    reference.tick(input, ticked, 24, 8);
+    skipping.tick(input, pushed, 8, 8);
+    skipping.push(input + 8, 16);
+    reference.tick(input + 24, ticked + 24, 16, 8);
+    skipping.tick(input + 24, pushed + 24, 16, 8);
+
+    bool same = true;
+    for (int i=24; i<40; i++){
+      same = same && ticked[i] == pushed[i];
+    }
+    check(same, "SlidingMaximum::push keeps the window history");
+  }
+
+  void testStereoConversion(){
+
+    // enough frames for a whole AVX-512 vector plus a remainder
+    const unsigned int nFrames = 37;
+    TonicFloat in[2 * nFrames];
+    for (unsigned int i=0; i<2 * nFrames; i++){
+      in[i] = (TonicFloat)i;
+    }
+
+    // every level splits and mixes the frames the same way
+    const SimdLevel original = simdLevel();
+    for (int level = SIMD_SCALAR; level <= SIMD_NEON; level++){
+      if (level != SIMD_SCALAR && level > detectedSimdLevel()) continue;
+      if (!setSimdLevel((SimdLevel)level)) continue;
+      TonicFloat mono[nFrames], left[nFrames], right[nFrames];
+      vmixstereo(in, mono, nFrames);
+      vdeinterleave(in, left, right, nFrames);
+      bool same = true;
+      for (unsigned int i=0; i<nFrames; i++){
+        same = same && left[i] == 2 * i && right[i] == 2 * i + 1 && mono[i] == 2 * i + 0.5f;
+      }
+      check(same, (string("stereo conversion is exact at ") + simdLevelName((SimdLevel)level)).c_str());
+    }
+    setSimdLevel(original);
+  }
+
+  void renderReverb( TonicUInt32 seed, float * buffer, unsigned int nFrames ){
+    Synth synth;
+    synth.setOutputGen(SineWave().freq(440) >> Reverb().roomSize(0.3f).seed(seed));
+    synth.fillBufferOfFloats(buffer, nFrames, 2);
+  }
+
+  void testReverbSeed(){
+
+    // the reflection taps are placed from the seed alone
+    const unsigned int nFrames = 8192;
+    static float first[nFrames * 2], second[nFrames * 2], other[nFrames * 2];
+    renderReverb(7, first, nFrames);
+    renderReverb(7, second, nFrames);
+    renderReverb(8, other, nFrames);
+    check(memcmp(first, second, sizeof(first)) == 0, "Reverb::seed repeats the reflections");
+    check(memcmp(first, other, sizeof(first)) != 0, "Reverb::seed changes the reflections");
+  }
+
+}
+
+int main( int argc, const char * argv[] ){
+
+  testMultiplierScheduling();
+  testScheduleStaleness();
+  testScratchDepth();
+  testDelayLineRateChange();
+  testSlidingMaximumPush();
+  testProfilerScheduled();
+  testStereoConversion();
+  testReverbSeed();
+
+  if (failures){
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+
+  printf("All checks passed\n");
+  return 0;
+}